@@ -10,6 +10,15 @@
  *
  * HISTORY
  *
+ * 2026-10-18
+ * -- board details now come from boards.txt instead of being hardcoded;
+ *    unknown revision codes continue with a warning
+ * -- results are compared against the expected ranges of the board
+ * -- added an adaptive sweep mode (-a [seconds]) that refines the test
+ *    sizes around the cache knees instead of walking 1..500
+ * -- the heap is grown once before the tests so every size runs on memory
+ *    that is already paged in
+ *
  * 2022-11-03 Andrew N. Sloss
  * -- added Raspberry Pi 3B (a22082)
  * -- fflush before closing file stream
@@ -34,6 +43,10 @@
 #include <stdbool.h>
 #include <stdint.h>
 #include <time.h>
+#include <math.h>
+#ifdef __GLIBC__
+#include <malloc.h>
+#endif
 
 // -- local libraries
 
@@ -43,14 +56,41 @@
 // * NEW TYPES
 // *********************************************************
 
+typedef struct
+{
+double lo;
+double hi;
+bool   set;
+} prototype_range_str;
+
 typedef struct
 {
 uint32_t model;
-uint8_t  memory_size_gb;
+float    memory_size_gb;
 float    revision;
+bool     known;
+char     name[32];
+char     soc[16];
+uint8_t  cores;
+uint32_t l1d_kb;
+uint32_t l2_kb;
+prototype_range_str write_mbps;   /* write test, MB/s */
+prototype_range_str mat_xy_ns;    /* [x][y] matrix, ns per element */
+prototype_range_str mat_yx_ns;    /* [y][x] matrix, ns per element */
+prototype_range_str temp_rise;    /* temperature rise over the run, C */
 } raspberry_str;
 
 
+typedef struct
+{
+uint32_t test;
+double   cputime;
+double   temperature;
+double   xy_time;
+double   yx_time;
+} prototype_point_str;
+
+
 // *********************************************************
 // * GLOBALS
 // *********************************************************
@@ -59,12 +99,22 @@ raspberry_str g_core;
 int32_t g_dim1[501][501]; 
 int32_t g_dim2[501][501]; 
 int32_t g_dimd[501][501]; 
+prototype_point_str g_points[501];
+bool g_measured[501];
 
 // *********************************************************
 // * CONSTANT
 // *********************************************************
 
 const float g_version = 0.01;
+const uint32_t g_max_test = 500;        /* limited by g_dim1..g_dimd */
+const double g_refine_threshold = 0.15; /* relative change in cost per unit of work */
+const double g_min_timing = 0.002;      /* repeat a test until it runs >= 2 ms */
+const uint32_t g_timing_repeats = 5;    /* timed batches per test, the fastest is kept */
+const uint32_t g_grid_passes = 2;       /* the first pass over the grid is a warm-up */
+const char *g_board_file = "boards.txt";
+const uint32_t g_check_from = 50;       /* sizes below this are too noisy to check */
+const double g_baseline_margin = 0.15;  /* +/- margin of the suggested ranges */
 
 // *********************************************************
 // * ROUTINES
@@ -147,7 +197,7 @@ mode++;
  
 bool prototype_modelname_read(char *model,char *cpucores)
 {
-char *line;
+char *line = NULL;
 FILE *fp = fopen("/proc/cpuinfo", "r");
 
 // -- initialize
@@ -231,6 +281,43 @@ fclose (temperatureFile);
 return T;
 }
 
+/*
+ * NAME: 
+ *
+ * prototype_range_parse
+ *
+ * DESCRIPTION: 
+ *
+ * Parses an expected range from the board file, "lo:hi" or "-" when 
+ * the board has not been calibrated yet.
+ *
+ * PARAMETRS:
+ * 
+ * const char *text - range text
+ * prototype_range_str *r - range to fill
+ *
+ * RETURN
+ *
+ * n/a
+ *
+ */
+
+void prototype_range_parse(const char *text, prototype_range_str *r)
+{
+
+// -- initialize
+
+assert(text!=NULL);
+assert(r!=NULL);
+
+r->set = false;
+
+// -- process
+
+  if (sscanf(text,"%lf:%lf",&r->lo,&r->hi) == 2 && r->lo <= r->hi)
+    r->set = true;
+}
+
 /*
  * NAME: 
  *
@@ -238,7 +325,9 @@ return T;
  *
  * DESCRIPTION: 
  *
- * Takes the string of the model name updates the g_core structure
+ * Takes the string of the model name, looks it up in g_board_file and
+ * updates the g_core structure. Unknown boards get the memory size and
+ * revision decoded from the revision code and a warning.
  *
  * PARAMETRS:
  * 
@@ -256,55 +345,65 @@ return T;
  
 void prototype_translate_information(char *model)
 {
+FILE *fp;
+char line[256];
+char code[16],name[32],soc[16],r1[32],r2[32],r3[32],r4[32];
+float ram;
+unsigned cores,l1d,l2;
 
 // -- initialize
 
 assert(model!=NULL);
 
-g_core.memory_size_gb = -1; /* not unknown */
-g_core.revision = 0.0;
+memset(&g_core,0,sizeof(g_core));
+g_core.model = (uint32_t)strtoul(model,NULL,16);
+g_core.revision = 1.0 + (g_core.model & 0xf) / 10.0;
+strcpy(g_core.name,"unknown");
+strcpy(g_core.soc,"unknown");
 
 // -- process
 
-  if (!strcmp(model,"d03114"))
-  {
-  g_core.model = 0xd03114;
-  g_core.memory_size_gb = 8;
-  g_core.revision = 1.4;
-  return;
-  } 
- 
-  if (!strcmp(model,"a03111"))
-  {
-  g_core.model = 0xa03111;
-  g_core.memory_size_gb = 1;
-  g_core.revision = 1.1;
-  return;
-  } 
-  
-  if (!strcmp(model,"a22082"))
-  {
-  g_core.model = 0xa22082;
-  g_core.memory_size_gb = 1;
-  g_core.revision = 1.2;
-  return;
-  }
+fp = fopen(g_board_file,"r");
+
+  if (fp == NULL)
+    printf ("-- W: cannot open %s\n",g_board_file);
 
-  if (!strcmp(model, "a03115"))
+  while (fp != NULL && fgets(line,sizeof(line),fp) != NULL)
   {
-  g_core.model = 0xa03115;
-  g_core.memory_size_gb = 8;
-  g_core.revision = 1.5;
-  return;
+    if (line[0] == '#')
+      continue;
+    if (sscanf(line,"%15s %31s %f %15s %u %u %u %31s %31s %31s %31s",
+               code,name,&ram,soc,&cores,&l1d,&l2,r1,r2,r3,r4) != 11)
+      continue;
+    if (strcmp(code,model))
+      continue;
+
+  g_core.known = true;
+  g_core.memory_size_gb = ram;
+  strcpy(g_core.name,name);
+  strcpy(g_core.soc,soc);
+  g_core.cores = cores;
+  g_core.l1d_kb = l1d;
+  g_core.l2_kb = l2;
+  prototype_range_parse(r1,&g_core.write_mbps);
+  prototype_range_parse(r2,&g_core.mat_xy_ns);
+  prototype_range_parse(r3,&g_core.mat_yx_ns);
+  prototype_range_parse(r4,&g_core.temp_rise);
+  break;
   }
 
+  if (fp != NULL)
+    fclose(fp);
 
-  // ** add more model types here
-  
 // -- finalize
-  
-printf("-- E: model type unknown %s",model);
-exit(1); 
+
+  if (!g_core.known)
+  {
+  /* new-style revision code: bits 20..22 give the memory size */
+    if (g_core.model & (1u << 23))
+      g_core.memory_size_gb = (256 << ((g_core.model >> 20) & 7)) / 1024.0;
+  printf ("-- W: model type unknown %s, add it to %s\n",model,g_board_file);
+  }
 }
 
 /*
@@ -429,6 +528,45 @@ assert(n>0);
   }        
 }
 
+/*
+ * NAME: 
+ *
+ * prototype_heap_prepare()
+ *
+ * DESCRIPTION: 
+ *
+ * Grows the heap to the largest write test once and keeps it, so every 
+ * test size reuses memory that is already paged in. Otherwise glibc 
+ * mmap()s the larger blocks, and the early runs pay page faults that 
+ * runs after its mmap threshold has grown do not. The matrix tests also
+ * run once at full size to page in g_dim1..g_dimd. 
+ *
+ * SIDE EFFECT:
+ *
+ * changes the malloc() tunables for the rest of the run
+ *
+ * RETURN
+ *
+ * n/a 
+ *
+ */
+
+void prototype_heap_prepare(void)
+{
+// -- initialize
+
+#ifdef __GLIBC__
+mallopt(M_MMAP_MAX,0);        /* serve every block from the heap */
+mallopt(M_TRIM_THRESHOLD,-1); /* never give the heap back */
+#endif
+
+// -- process
+
+prototype_write_speed(g_max_test*256);
+prototype_matrix_calc(g_max_test,true);
+prototype_matrix_calc(g_max_test,false);
+}
+
 /*
  * NAME: 
  *
@@ -447,7 +585,7 @@ assert(n>0);
  *
  * SIDE EFFECT:
  *
- * none, test should do busy work for timgin purposes
+ * fills g_points, otherwise busy work for timing purposes
  * 
  * RETURN
  *
@@ -521,16 +659,530 @@ fprintf(H2,"# .tests complete .time taken \n");
   //   xy_time,
   //   yx_time
   //   );
+  g_points[test].test = test;
+  g_points[test].cputime = cpu_time_used;
+  g_points[test].temperature = prototype_temperature_read() - temp_baseline;
+  g_points[test].xy_time = xy_time;
+  g_points[test].yx_time = yx_time;
+  g_measured[test] = true;
+    
   fprintf (H1,"%d %lf %6.3f %lf %lf\n",
        test,
        cpu_time_used,
-       prototype_temperature_read() - temp_baseline,
+       g_points[test].temperature,
        xy_time,
        yx_time
        );
   } 
 }
 
+/*
+ * NAME: 
+ *
+ * prototype_timed_run()
+ *
+ * DESCRIPTION: 
+ *
+ * Runs one of the three tests at size test, repeating it until the total 
+ * reaches g_min_timing so small sizes are not lost in the clock() 
+ * resolution. The batch is then timed g_timing_repeats times and the 
+ * fastest is kept, which drops runs hit by interrupts or other tasks.
+ *
+ * PARAMETRS:
+ * 
+ * int kind - 0 write speed, 1 matrix [x][y], 2 matrix [y][x]
+ * uint32_t test - test size
+ *
+ * RETURN
+ *
+ * double - seconds for a single run
+ *
+ */
+
+double prototype_timed_run(int kind, uint32_t test)
+{
+clock_t start, end;
+uint32_t reps,r,k;
+double elapsed,best;
+
+// -- initialize
+
+assert(test>0 && test<=g_max_test);
+reps = 1;
+k = 0;
+best = 0.0;
+
+// -- process
+
+  for (;;)
+  {
+  start = clock();
+  
+    for (r=0; r<reps; r++)
+    {
+      switch (kind)
+      {
+      case 0: prototype_write_speed(test*256); break;
+      case 1: prototype_matrix_calc(test,true); break;
+      default: prototype_matrix_calc(test,false); break;
+      }
+    }
+    
+  end = clock();
+  elapsed = ((double) (end - start)) / CLOCKS_PER_SEC;
+  
+    if (elapsed < g_min_timing && reps < (1u<<20))
+    {
+    reps *= 2;  // too short to time, discard
+    continue;
+    }
+    
+    if (k == 0 || elapsed/reps < best)
+      best = elapsed/reps;
+      
+    if (++k >= g_timing_repeats)
+      break;
+  }
+
+// -- finalize
+
+return best;
+}
+
+/*
+ * NAME: 
+ *
+ * prototype_measure_point()
+ *
+ * DESCRIPTION: 
+ *
+ * Measures all three tests at one size and stores the result in 
+ * g_points[test]. A size that was measured before keeps the faster 
+ * time of each test.
+ *
+ * PARAMETRS:
+ * 
+ * uint32_t test - test size
+ * double temp_baseline - temperature baseline
+ *
+ * SIDE EFFECT:
+ *
+ * updates g_points and g_measured
+ *
+ * RETURN
+ *
+ * n/a 
+ *
+ */
+
+void prototype_measure_point(uint32_t test, double temp_baseline)
+{
+prototype_point_str *p;
+double t;
+
+// -- initialize
+
+assert(test>0 && test<=g_max_test);
+p = &g_points[test];
+prototype_visual_progress();
+
+// -- process
+
+p->test = test;
+t = prototype_timed_run(0,test);
+p->cputime = (g_measured[test] && p->cputime < t) ? p->cputime : t;
+t = prototype_timed_run(1,test);
+p->xy_time = (g_measured[test] && p->xy_time < t) ? p->xy_time : t;
+t = prototype_timed_run(2,test);
+p->yx_time = (g_measured[test] && p->yx_time < t) ? p->yx_time : t;
+p->temperature = prototype_temperature_read() - temp_baseline;
+
+// -- finalize
+
+g_measured[test] = true;
+}
+
+/*
+ * NAME: 
+ *
+ * prototype_interval_score()
+ *
+ * DESCRIPTION: 
+ *
+ * Compares the cost per unit of work at both ends of an interval. The
+ * write test does O(n) work and the matrix tests O(n^2), so a flat cost
+ * means the time/size curve keeps its slope; a change marks a knee.
+ *
+ * PARAMETRS:
+ * 
+ * uint32_t lo - lower measured test size
+ * uint32_t hi - upper measured test size
+ *
+ * RETURN
+ *
+ * double - largest relative change of the three tests
+ *
+ */
+
+double prototype_interval_score(uint32_t lo, uint32_t hi)
+{
+const prototype_point_str *a = &g_points[lo];
+const prototype_point_str *b = &g_points[hi];
+double ca[3],cb[3],score,d;
+int i;
+
+// -- initialize
+
+ca[0] = a->cputime / lo;
+ca[1] = a->xy_time / ((double)lo*lo);
+ca[2] = a->yx_time / ((double)lo*lo);
+cb[0] = b->cputime / hi;
+cb[1] = b->xy_time / ((double)hi*hi);
+cb[2] = b->yx_time / ((double)hi*hi);
+score = 0.0;
+
+// -- process
+
+  for (i=0; i<3; i++)
+  {
+    if (ca[i] <= 0.0 || cb[i] <= 0.0)
+      continue;
+  d = fabs(cb[i]-ca[i]) / (ca[i] > cb[i] ? ca[i] : cb[i]);
+    if (d > score)
+      score = d;
+  }
+
+// -- finalize
+
+return score;
+}
+
+/*
+ * NAME: 
+ *
+ * prototype_wall_seconds()
+ *
+ * DESCRIPTION: 
+ *
+ * Monotonic wall-clock time. clock() only counts CPU time, so it misses
+ * the time spent blocked on temperature reads or throttled.
+ *
+ * RETURN
+ *
+ * double - seconds from an arbitrary start
+ *
+ */
+
+double prototype_wall_seconds(void)
+{
+struct timespec ts;
+
+clock_gettime(CLOCK_MONOTONIC,&ts);
+return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+/*
+ * NAME: 
+ *
+ * prototype_adaptive_tests()
+ *
+ * DESCRIPTION: 
+ *
+ * Adaptive replacement for prototype_tests(). Starts from a geometric
+ * grid (1,2,4..256,500), measured g_grid_passes times so no interval is
+ * scored from a first, cold sample, and then keeps splitting the 
+ * interval whose cost per unit of work changes the most, until no interval is above 
+ * g_refine_threshold or the time budget is spent. main.dat gets the same
+ * columns as prototype_tests() so plot1..plot3 work unchanged. 
+ *
+ * PARAMETRS:
+ * 
+ * FILE *H1 - file handle of the test details
+ * FILE *H2 - file handle of test run speeds
+ * double temp_baseline - temperature baseline
+ * double budget - wall-clock time budget in seconds
+ *
+ * SIDE EFFECT:
+ *
+ * fills g_points
+ *
+ * RETURN
+ *
+ * n/a 
+ *
+ */
+
+void prototype_adaptive_tests (FILE *H1, FILE *H2, double temp_baseline, double budget)
+{
+uint32_t test,lo,hi,best_lo,best_hi,points,pass;
+double test_start,block_start;
+double score,best,spent;
+
+// -- initialize
+
+assert(H1!=NULL);
+assert(H2!=NULL);
+
+memset(g_measured,0,sizeof(g_measured));
+test_start = prototype_wall_seconds();
+block_start = test_start;
+points = 0;
+
+fprintf(H1,"# .test .cputime .temperature .time_mat1 .time_mat2\n");
+fprintf(H2,"# .tests complete .time taken \n");
+
+// -- process
+
+  for (pass=0; pass<g_grid_passes; pass++)
+  {
+    for (test=1; test<g_max_test; test*=2)
+      prototype_measure_point(test,temp_baseline);
+  prototype_measure_point(g_max_test,temp_baseline);
+  }
+  
+  for (test=1; test<=g_max_test; test++)
+    if (g_measured[test])
+      points++;
+
+  for (;;)
+  {
+  spent = prototype_wall_seconds() - test_start;
+    if (spent >= budget)
+      break;
+      
+  best = g_refine_threshold;
+  best_lo = best_hi = 0;
+  lo = 1;
+  
+    for (hi=2; hi<=g_max_test; hi++)
+    {
+      if (!g_measured[hi])
+        continue;
+        
+      if (hi-lo > 1)
+      {
+      score = prototype_interval_score(lo,hi);
+        if (score > best)
+        {
+        best = score;
+        best_lo = lo;
+        best_hi = hi;
+        }
+      }
+    lo = hi;
+    }
+    
+    if (best_hi == 0)
+      break;
+      
+  prototype_measure_point((best_lo+best_hi)/2,temp_baseline);
+  points++;
+  
+    if ((points % 10)==0)
+    {
+    spent = prototype_wall_seconds() - block_start;
+    printf ("........... [%d] %lf sec \n",points,spent);
+    fprintf (H2,"%d %lf\n",points,spent);
+    fflush(H2);
+    block_start = prototype_wall_seconds();
+    }
+  }
+
+// -- finalize
+
+  for (test=1; test<=g_max_test; test++)
+  {
+    if (!g_measured[test])
+      continue;
+      
+  fprintf (H1,"%d %lf %6.3f %lf %lf\n",
+       test,
+       g_points[test].cputime,
+       g_points[test].temperature,
+       g_points[test].xy_time,
+       g_points[test].yx_time
+       );
+  }
+  
+printf ("\n-- I: ADP %d sizes measured in %lf sec\n",points,
+        prototype_wall_seconds() - test_start);
+}
+
+/*
+ * NAME: 
+ *
+ * prototype_compare_double()
+ *
+ * DESCRIPTION: 
+ *
+ * qsort() comparison for doubles
+ *
+ */
+
+int prototype_compare_double(const void *a, const void *b)
+{
+double x = *(const double *)a;
+double y = *(const double *)b;
+
+return (x > y) - (x < y);
+}
+
+/*
+ * NAME: 
+ *
+ * prototype_median_metric()
+ *
+ * DESCRIPTION: 
+ *
+ * Median of one metric over the measured sizes >= g_check_from. The
+ * metrics are normalised by the amount of work so every size counts.
+ *
+ * PARAMETRS:
+ * 
+ * int kind - 0 write speed MB/s, 1 matrix [x][y] ns, 2 matrix [y][x] ns
+ *
+ * RETURN
+ *
+ * double - median, or 0.0 if no size qualified
+ *
+ */
+
+double prototype_median_metric(int kind)
+{
+double v[501];
+uint32_t test;
+int n;
+const prototype_point_str *p;
+
+// -- initialize
+
+n = 0;
+
+// -- process
+
+  for (test=g_check_from; test<=g_max_test; test++)
+  {
+    if (!g_measured[test])
+      continue;
+  p = &g_points[test];
+    if (kind == 0 && p->cputime > 0.0)
+      v[n++] = (test * 256.0 / 1024.0) / p->cputime;
+    if (kind == 1 && p->xy_time > 0.0)
+      v[n++] = p->xy_time * 1e9 / ((double)test*test);
+    if (kind == 2 && p->yx_time > 0.0)
+      v[n++] = p->yx_time * 1e9 / ((double)test*test);
+  }
+
+// -- finalize
+
+  if (n == 0)
+    return 0.0;
+qsort(v,n,sizeof(double),prototype_compare_double);
+return (n & 1) ? v[n/2] : (v[n/2-1] + v[n/2]) / 2.0;
+}
+
+/*
+ * NAME: 
+ *
+ * prototype_range_check()
+ *
+ * DESCRIPTION: 
+ *
+ * Prints one result against its expected range.
+ *
+ * PARAMETRS:
+ * 
+ * const char *label - short result name
+ * double value - measured value
+ * const prototype_range_str *r - expected range
+ *
+ * RETURN
+ *
+ * int 1 if the value is outside the range, otherwise 0
+ *
+ */
+
+int prototype_range_check(const char *label, double value, const prototype_range_str *r)
+{
+  if (!r->set)
+  {
+  printf ("-- I: %s %10.3f (no expected range)\n",label,value);
+  return 0;
+  }
+  
+  if (value < r->lo || value > r->hi)
+  {
+  printf ("-- W: ANOMALY %s %10.3f outside %g:%g\n",label,value,r->lo,r->hi);
+  return 1;
+  }
+  
+printf ("-- I: %s %10.3f ok (%g:%g)\n",label,value,r->lo,r->hi);
+return 0;
+}
+
+/*
+ * NAME: 
+ *
+ * prototype_check_results()
+ *
+ * DESCRIPTION: 
+ *
+ * Compares the run against the expected ranges of the board so boards
+ * with bad RAM timings, failing cooling or wrong firmware stand out. 
+ * Also prints a BASELINE line, +/- g_baseline_margin around this run, 
+ * that can be pasted into g_board_file once a known good board is 
+ * measured.
+ *
+ * PARAMETRS:
+ * 
+ * char *model - model string
+ * double temp_rise - temperature rise over the run
+ *
+ * RETURN
+ *
+ * int - number of anomalies
+ *
+ */
+
+int prototype_check_results(char *model, double temp_rise)
+{
+double write_mbps,xy_ns,yx_ns,m;
+int anomalies;
+
+// -- initialize
+
+write_mbps = prototype_median_metric(0);
+xy_ns = prototype_median_metric(1);
+yx_ns = prototype_median_metric(2);
+m = g_baseline_margin;
+anomalies = 0;
+
+// -- process
+
+  if (write_mbps <= 0.0 || xy_ns <= 0.0 || yx_ns <= 0.0)
+  {
+  printf ("-- W: not enough results to compare (sizes >= %d)\n",g_check_from);
+  return 0;
+  }
+
+anomalies += prototype_range_check("WRT MB/s  ",write_mbps,&g_core.write_mbps);
+anomalies += prototype_range_check("MXY ns/el ",xy_ns,&g_core.mat_xy_ns);
+anomalies += prototype_range_check("MYX ns/el ",yx_ns,&g_core.mat_yx_ns);
+anomalies += prototype_range_check("TEM rise C",temp_rise,&g_core.temp_rise);
+
+// -- finalize
+
+printf ("-- I: BASELINE %s %s %g %s %d %d %d %.0f:%.0f %.2f:%.2f %.2f:%.2f 0:%.1f\n",
+        model[0] ? model : "??????", g_core.name, g_core.memory_size_gb, g_core.soc,
+        g_core.cores, g_core.l1d_kb, g_core.l2_kb,
+        write_mbps*(1-m), write_mbps*(1+m),
+        xy_ns*(1-m), xy_ns*(1+m),
+        yx_ns*(1-m), yx_ns*(1+m),
+        temp_rise > 0.0 ? temp_rise*(1+m) : 1.0);
+printf ("-- I: CHK %d anomalies\n",anomalies);
+return anomalies;
+}
+
 /*
  * NAME: 
  *
@@ -542,7 +1194,7 @@ fprintf(H2,"# .tests complete .time taken \n");
  *
  * PARAMETRS:
  * 
- * n/a
+ * -a [seconds] - adaptive sweep with a wall-clock budget (default 60 sec)
  *
  * RETURN
  *
@@ -550,17 +1202,23 @@ fprintf(H2,"# .tests complete .time taken \n");
  *
  */
 
-int main(void)
+int main(int argc, char *argv[])
 {
 double temp_baseline;
 char model[40];
 char cpucore[20];
 FILE *H1,*H2;
 uint32_t testruns;
+bool adaptive;
+double budget;
+double temp_rise;
 
 // -- initialize
 
 testruns = 500;
+model[0] = 0;
+adaptive = (argc > 1 && !strcmp(argv[1],"-a"));
+budget = (adaptive && argc > 2) ? atof(argv[2]) : 60.0;
 
 H1 = fopen("main.dat","w");
 H2 = fopen("test.dat","w");
@@ -569,6 +1227,7 @@ assert(H1!=NULL);
 assert(H2!=NULL);
   
 temp_baseline = prototype_temperature_read();  
+prototype_heap_prepare();
   
 // -- process
 
@@ -576,15 +1235,28 @@ printf ("-- I: Raspberry Pi Simple Test [ver:%1.2f]\n",g_version);
   if (!prototype_modelname_read(model,cpucore))
     printf ("-- I: MOD %s \n",model); // revision
 prototype_translate_information(model);
-printf ("-- I: MEM %dGB\n",g_core.memory_size_gb);
+printf ("-- I: BRD %s %s, %d cores, L1d %dKB, L2 %dKB\n",
+        g_core.name,g_core.soc,g_core.cores,g_core.l1d_kb,g_core.l2_kb);
+printf ("-- I: MEM %gGB\n",g_core.memory_size_gb);
 printf ("-- I: REV %1.1f \n",g_core.revision);  
 printf ("-- I: TEM (baseline):  %6.3f C (%s) \n", 
         temp_baseline, 
         temp_baseline > 45.0 ? "TOO HOT - NOT RUNNING" : "WARM");
-printf ("-- I: TST %d\n",testruns);
+  if (adaptive)
+    printf ("-- I: TST adaptive, budget %1.0f sec\n",budget);
+  else
+    printf ("-- I: TST %d\n",testruns);
+  if (temp_baseline < 60.0)
+  {
+    if (adaptive)
+      prototype_adaptive_tests(H1,H2,temp_baseline,budget);
+    else
+      prototype_tests(H1,H2,temp_baseline,testruns);
+  }
+temp_rise = prototype_temperature_read()-temp_baseline;
+printf ("-- I: TEM  %6.3f C\n", temp_rise);
   if (temp_baseline < 60.0)
-    prototype_tests(H1,H2,temp_baseline,testruns);
-printf ("-- I: TEM  %6.3f C\n", prototype_temperature_read()-temp_baseline);
+    prototype_check_results(model,temp_rise);
 
 // -- finalize
 
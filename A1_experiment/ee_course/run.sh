@@ -12,6 +12,7 @@ cc prototype.c -o prototype
 echo "**** execute test - 5 to 10 minutes "
 
 ./prototype
+# ./prototype -a 120   # adaptive sweep instead, 2 minute budget
 
 echo "**** graph the data "
 
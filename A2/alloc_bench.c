@@ -0,0 +1,563 @@
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <unistd.h>
+#include <sched.h>
+#include <pthread.h>
+#include <sys/wait.h>
+
+#include "bench_stats.h"
+#include "alloc_bench.h"
+
+#define ALLOC_OPS_PER_THREAD 200000
+#define ALLOC_MAX_THREADS 4
+#define LAT_SAMPLE_EVERY 16
+#define LAT_SAMPLES_PER_THREAD (ALLOC_OPS_PER_THREAD / LAT_SAMPLE_EVERY + 1)
+#define BATCH_OBJECTS 64
+#define CHURN_WINDOW 4096
+#define RING_SLOTS 1024
+#define MAX_OBJECT_SIZE 2048
+#define TIMER_CAL_SAMPLES 1001
+#define PROBE_MIN_LIVE (4 * 1024)       // live bytes before the first footprint probe
+
+#define ARENA_SIZE (1024 * 1024)         // 1MB per thread
+#define POOL_BLOCK MAX_OBJECT_SIZE
+#define POOL_GROW_BLOCKS 64
+#define SLAB_CLASSES 8                   // 32B .. 4KB
+#define SLAB_CHUNK (64 * 1024)           // 64KB carved per refill
+#define SLAB_HDR 16
+
+enum { SCEN_BATCH, SCEN_CHURN, SCEN_XTHREAD, SCEN_COUNT };
+static const char *scenario_names[SCEN_COUNT] = {"batch", "churn", "xthread"};
+
+/**
+ * @brief Allocator under test. Per-thread state comes from thread_ctx();
+ *        end_batch() is called when a request-scoped batch dies.
+ */
+typedef struct {
+    const char *name;
+    int request_scoped_only;
+    void *(*create)(int threads);
+    void *(*thread_ctx)(void *shared, int tid);
+    void *(*alloc)(void *tctx, size_t size);
+    void (*release)(void *tctx, void *p);
+    void (*end_batch)(void *tctx);
+} allocator_t;
+
+typedef struct free_node { struct free_node *next; } free_node_t;
+
+// ---- glibc malloc (or whatever LD_PRELOAD put in front of it) ----
+
+static void *sys_create(int threads) { (void)threads; return NULL; }
+static void *sys_thread_ctx(void *shared, int tid) { (void)shared; (void)tid; return NULL; }
+static void *sys_alloc(void *tctx, size_t size) { (void)tctx; return malloc(size); }
+static void sys_release(void *tctx, void *p) { (void)tctx; free(p); }
+
+// ---- bump arena: one per thread, freed wholesale at end of batch ----
+
+typedef struct {
+    uint8_t *base;
+    size_t off;
+    char pad[64 - sizeof(uint8_t *) - sizeof(size_t)];
+} arena_t;
+
+static void *arena_create(int threads) {
+    arena_t *arenas = calloc(threads, sizeof(arena_t));
+    for (int i = 0; arenas && i < threads; i++) arenas[i].base = malloc(ARENA_SIZE);
+    return arenas;
+}
+static void *arena_thread_ctx(void *shared, int tid) { return (arena_t *)shared + tid; }
+static void *arena_alloc(void *tctx, size_t size) {
+    arena_t *a = (arena_t *)tctx;
+    size_t off = (a->off + 15) & ~(size_t)15;
+    if (!a->base || off + size > ARENA_SIZE) return NULL;
+    a->off = off + size;
+    return a->base + off;
+}
+static void arena_release(void *tctx, void *p) { (void)tctx; (void)p; }
+static void arena_end_batch(void *tctx) { ((arena_t *)tctx)->off = 0; }
+
+// ---- fixed-size pool: one shared free list of POOL_BLOCK blocks ----
+
+typedef struct {
+    pthread_mutex_t lock;
+    free_node_t *free;
+} pool_t;
+
+static void *pool_create(int threads) {
+    pool_t *pool = calloc(1, sizeof(pool_t));
+    (void)threads;
+    if (pool) pthread_mutex_init(&pool->lock, NULL);
+    return pool;
+}
+static void *pool_thread_ctx(void *shared, int tid) { (void)tid; return shared; }
+static void *pool_alloc(void *tctx, size_t size) {
+    pool_t *pool = (pool_t *)tctx;
+    if (size > POOL_BLOCK) return NULL;
+    pthread_mutex_lock(&pool->lock);
+    if (!pool->free) {
+        uint8_t *chunk = malloc((size_t)POOL_BLOCK * POOL_GROW_BLOCKS);
+        for (int i = 0; chunk && i < POOL_GROW_BLOCKS; i++) {
+            free_node_t *n = (free_node_t *)(chunk + (size_t)i * POOL_BLOCK);
+            n->next = pool->free;
+            pool->free = n;
+        }
+    }
+    free_node_t *n = pool->free;
+    if (n) pool->free = n->next;
+    pthread_mutex_unlock(&pool->lock);
+    return n;
+}
+static void pool_release(void *tctx, void *p) {
+    pool_t *pool = (pool_t *)tctx;
+    free_node_t *n = (free_node_t *)p;
+    pthread_mutex_lock(&pool->lock);
+    n->next = pool->free;
+    pool->free = n;
+    pthread_mutex_unlock(&pool->lock);
+}
+
+// ---- per-thread slab: size classes, lock-free remote frees to the owner ----
+
+typedef struct slab_cache {
+    free_node_t *local[SLAB_CLASSES];
+    free_node_t *remote[SLAB_CLASSES];
+    char pad[64];
+} slab_cache_t;
+
+typedef struct {
+    slab_cache_t *owner;
+    uint32_t cls;
+    uint32_t unused;
+} slab_hdr_t;
+
+static size_t slab_class_size(int cls) { return (size_t)32 << cls; }
+
+static int slab_class_of(size_t size) {
+    int cls = 0;
+    while (cls < SLAB_CLASSES - 1 && slab_class_size(cls) < size + SLAB_HDR) cls++;
+    return cls;
+}
+
+static void *slab_create(int threads) { return calloc(threads, sizeof(slab_cache_t)); }
+static void *slab_thread_ctx(void *shared, int tid) { return (slab_cache_t *)shared + tid; }
+static void *slab_alloc(void *tctx, size_t size) {
+    slab_cache_t *c = (slab_cache_t *)tctx;
+    int cls = slab_class_of(size);
+    size_t bsize = slab_class_size(cls);
+    if (size + SLAB_HDR > bsize) return NULL;
+
+    if (!c->local[cls]) c->local[cls] = __atomic_exchange_n(&c->remote[cls], NULL, __ATOMIC_ACQUIRE);
+    if (!c->local[cls]) {
+        uint8_t *chunk = malloc(SLAB_CHUNK);
+        if (!chunk) return NULL;
+        for (size_t off = 0; off + bsize <= SLAB_CHUNK; off += bsize) {
+            free_node_t *n = (free_node_t *)(chunk + off + SLAB_HDR);
+            n->next = c->local[cls];
+            c->local[cls] = n;
+        }
+    }
+
+    free_node_t *n = c->local[cls];
+    c->local[cls] = n->next;
+    slab_hdr_t *h = (slab_hdr_t *)((uint8_t *)n - SLAB_HDR);
+    h->owner = c;
+    h->cls = cls;
+    return n;
+}
+static void slab_release(void *tctx, void *p) {
+    slab_hdr_t *h = (slab_hdr_t *)((uint8_t *)p - SLAB_HDR);
+    slab_cache_t *owner = h->owner;
+    free_node_t *n = (free_node_t *)p;
+    if (owner == tctx) {
+        n->next = owner->local[h->cls];
+        owner->local[h->cls] = n;
+        return;
+    }
+    n->next = __atomic_load_n(&owner->remote[h->cls], __ATOMIC_RELAXED);
+    while (!__atomic_compare_exchange_n(&owner->remote[h->cls], &n->next, n, 1,
+                                        __ATOMIC_RELEASE, __ATOMIC_RELAXED)) {
+    }
+}
+
+static const allocator_t allocators[] = {
+    {"malloc", 0, sys_create, sys_thread_ctx, sys_alloc, sys_release, NULL},
+    {"arena", 1, arena_create, arena_thread_ctx, arena_alloc, arena_release, arena_end_batch},
+    {"pool", 0, pool_create, pool_thread_ctx, pool_alloc, pool_release, NULL},
+    {"slab", 0, slab_create, slab_thread_ctx, slab_alloc, slab_release, NULL},
+};
+
+// ---- workload ----
+
+typedef struct {
+    void *slot[RING_SLOTS];
+    size_t size[RING_SLOTS];
+    size_t live;
+    char pad0[64];
+    unsigned long head;
+    char pad1[64];
+    unsigned long tail;
+    char pad2[64];
+} spsc_ring_t;
+
+struct alloc_worker;
+
+/**
+ * @brief Allocator footprint at the live-set peak: anonymous RSS and the
+ *        live bytes summed over all threads at the same moment.
+ */
+typedef struct {
+    pthread_mutex_t lock;
+    struct alloc_worker *workers;
+    int threads;
+    size_t live;
+    long rss_kb;
+} footprint_t;
+
+typedef struct alloc_worker {
+    const allocator_t *a;
+    void *shared;
+    int tid;
+    int scenario;
+    spsc_ring_t *ring;
+    pthread_barrier_t *start;
+    double *lat;
+    int lat_n;
+    long failures;
+    void **churn_objs;           // CHURN_WINDOW entries, owned by run_cell()
+    size_t *churn_sizes;
+    footprint_t *fp;
+    size_t live;                 // current live bytes, read by other threads' probes
+    size_t probed_live;
+    double probe_ns;
+} alloc_worker_t;
+
+// Median cost of a back-to-back bench_now_ns() pair; set before the cells fork.
+static double timer_overhead_ns;
+
+/**
+ * @brief Measures what an empty bench_now_ns() bracket reads, so it can be
+ *        taken out of the per-allocation latencies.
+ */
+static double calibrate_timer(void) {
+    double samples[TIMER_CAL_SAMPLES];
+    bench_stats_t st;
+    for (int i = 0; i < TIMER_CAL_SAMPLES; i++) {
+        double t0 = bench_now_ns();
+        samples[i] = bench_now_ns() - t0;
+    }
+    bench_stats_compute(samples, TIMER_CAL_SAMPLES, &st);
+    return st.median;
+}
+
+/**
+ * @brief Reads a "Vm...:  <n> kB" field from /proc/self/status.
+ */
+static long read_status_kb(const char *field) {
+    long val = 0;
+    FILE *fp = fopen("/proc/self/status", "r");
+    if (fp) {
+        char line[128];
+        size_t len = strlen(field);
+        while (fgets(line, sizeof(line), fp)) {
+            if (strncmp(line, field, len) == 0 && line[len] == ':') {
+                val = atol(line + len + 1);
+                break;
+            }
+        }
+        fclose(fp);
+    }
+    return val;
+}
+
+/**
+ * @brief Publishes this thread's live bytes. Each time they grow 1/16 past
+ *        the last probe, samples RSS together with the live bytes of all
+ *        threads and keeps the sample with the largest live set. Probe
+ *        time is left out of the throughput.
+ */
+static void note_live(alloc_worker_t *w, size_t live) {
+    __atomic_store_n(&w->live, live, __ATOMIC_RELAXED);
+    if (live < PROBE_MIN_LIVE || live < w->probed_live + w->probed_live / 16) return;
+
+    double t0 = bench_now_ns();
+    footprint_t *fp = w->fp;
+    size_t total = 0;
+    w->probed_live = live;
+    for (int t = 0; t < fp->threads; t++) total += __atomic_load_n(&fp->workers[t].live, __ATOMIC_RELAXED);
+    long rss = read_status_kb("RssAnon");
+    pthread_mutex_lock(&fp->lock);
+    if (total > fp->live) {
+        fp->live = total;
+        fp->rss_kb = rss;
+    }
+    pthread_mutex_unlock(&fp->lock);
+    w->probe_ns += bench_now_ns() - t0;
+}
+
+static uint32_t xorshift(uint32_t *rng) {
+    *rng ^= *rng << 13; *rng ^= *rng >> 17; *rng ^= *rng << 5;
+    return *rng;
+}
+
+/**
+ * @brief Object size mix: mostly small, with a long tail up to 2KB.
+ */
+static size_t draw_size(uint32_t *rng) {
+    uint32_t r = xorshift(rng);
+    uint32_t bucket = r % 100;
+    r >>= 8;
+    if (bucket < 50) return 16 + r % 48;
+    if (bucket < 80) return 64 + r % 192;
+    if (bucket < 95) return 256 + r % 768;
+    return 1024 + r % 1024;
+}
+
+/**
+ * @brief Allocates, touches, and samples the latency of every LAT_SAMPLE_EVERY'th call,
+ *        net of the timer's own overhead.
+ */
+static void *timed_alloc(alloc_worker_t *w, void *tctx, size_t size, long op) {
+    void *p;
+    if (op % LAT_SAMPLE_EVERY == 0 && w->lat_n < LAT_SAMPLES_PER_THREAD) {
+        double t0 = bench_now_ns();
+        p = w->a->alloc(tctx, size);
+        double dt = bench_now_ns() - t0 - timer_overhead_ns;
+        w->lat[w->lat_n++] = dt > 0 ? dt : 0;
+    } else {
+        p = w->a->alloc(tctx, size);
+    }
+    if (p) memset(p, (int)op, size < 64 ? size : 64);
+    else w->failures++;
+    return p;
+}
+
+static void run_batch(alloc_worker_t *w, void *tctx, uint32_t *rng) {
+    void *objs[BATCH_OBJECTS];
+    for (long op = 0; op < ALLOC_OPS_PER_THREAD;) {
+        size_t live = 0;
+        for (int i = 0; i < BATCH_OBJECTS; i++, op++) {
+            size_t size = draw_size(rng);
+            objs[i] = timed_alloc(w, tctx, size, op);
+            live += size;
+        }
+        note_live(w, live);
+        for (int i = BATCH_OBJECTS - 1; i >= 0; i--)
+            if (objs[i]) w->a->release(tctx, objs[i]);
+        if (w->a->end_batch) w->a->end_batch(tctx);
+        note_live(w, 0);
+    }
+}
+
+static void run_churn(alloc_worker_t *w, void *tctx, uint32_t *rng) {
+    void **objs = w->churn_objs;
+    size_t *sizes = w->churn_sizes;
+    size_t live = 0;
+    for (int i = 0; i < CHURN_WINDOW; i++) {
+        sizes[i] = draw_size(rng);
+        objs[i] = w->a->alloc(tctx, sizes[i]);
+        live += sizes[i];
+        note_live(w, live);
+    }
+    for (long op = 0; op < ALLOC_OPS_PER_THREAD; op++) {
+        int i = (int)(xorshift(rng) % CHURN_WINDOW);
+        if (objs[i]) w->a->release(tctx, objs[i]);
+        live -= sizes[i];
+        sizes[i] = draw_size(rng);
+        objs[i] = timed_alloc(w, tctx, sizes[i], op);
+        live += sizes[i];
+        note_live(w, live);
+    }
+    for (int i = 0; i < CHURN_WINDOW; i++)
+        if (objs[i]) w->a->release(tctx, objs[i]);
+}
+
+/**
+ * @brief Even tids produce into the ring, odd tids consume and free.
+ */
+static void run_xthread(alloc_worker_t *w, void *tctx, uint32_t *rng) {
+    spsc_ring_t *ring = w->ring;
+    if (w->tid % 2 == 0) {
+        for (long op = 0; op < ALLOC_OPS_PER_THREAD; op++) {
+            size_t size = draw_size(rng);
+            void *p = timed_alloc(w, tctx, size, op);
+            if (!p) continue;
+            note_live(w, __atomic_add_fetch(&ring->live, size, __ATOMIC_RELAXED));
+            while (ring->head - __atomic_load_n(&ring->tail, __ATOMIC_ACQUIRE) == RING_SLOTS)
+                sched_yield();
+            ring->slot[ring->head % RING_SLOTS] = p;
+            ring->size[ring->head % RING_SLOTS] = size;
+            __atomic_store_n(&ring->head, ring->head + 1, __ATOMIC_RELEASE);
+        }
+        while (ring->head - __atomic_load_n(&ring->tail, __ATOMIC_ACQUIRE) == RING_SLOTS)
+            sched_yield();
+        ring->slot[ring->head % RING_SLOTS] = NULL;
+        __atomic_store_n(&ring->head, ring->head + 1, __ATOMIC_RELEASE);
+    } else {
+        for (;;) {
+            while (__atomic_load_n(&ring->head, __ATOMIC_ACQUIRE) == ring->tail) sched_yield();
+            void *p = ring->slot[ring->tail % RING_SLOTS];
+            size_t size = ring->size[ring->tail % RING_SLOTS];
+            __atomic_store_n(&ring->tail, ring->tail + 1, __ATOMIC_RELEASE);
+            if (!p) break;
+            w->a->release(tctx, p);
+            __atomic_sub_fetch(&ring->live, size, __ATOMIC_RELAXED);
+        }
+    }
+}
+
+static void* alloc_worker(void* args) {
+    alloc_worker_t *w = (alloc_worker_t *)args;
+    uint32_t rng = 0x9E3779B9u ^ (uint32_t)(w->tid * 7919 + 1);
+    void *tctx = w->a->thread_ctx(w->shared, w->tid);
+
+    pthread_barrier_wait(w->start); // ready: run_cell() samples RSS now
+    pthread_barrier_wait(w->start);
+    switch (w->scenario) {
+    case SCEN_BATCH: run_batch(w, tctx, &rng); break;
+    case SCEN_CHURN: run_churn(w, tctx, &rng); break;
+    case SCEN_XTHREAD: run_xthread(w, tctx, &rng); break;
+    }
+    return NULL;
+}
+
+typedef struct {
+    int ok;
+    double ops_per_sec;
+    long failures;
+    long rss_growth_kb;
+    double fragmentation;
+    bench_stats_t lat;
+} alloc_result_t;
+
+/**
+ * @brief Runs one allocator/scenario/thread-count cell. Called in a forked
+ *        child so RSS and allocator state start clean for every cell.
+ */
+static void run_cell(const allocator_t *a, int scenario, int threads, alloc_result_t *res) {
+    memset(res, 0, sizeof(*res));
+
+    void *shared = a->create(threads);
+    alloc_worker_t workers[ALLOC_MAX_THREADS];
+    pthread_t tids[ALLOC_MAX_THREADS];
+    spsc_ring_t *rings = calloc(threads / 2 + 1, sizeof(spsc_ring_t));
+    double *lat = malloc(sizeof(double) * LAT_SAMPLES_PER_THREAD * threads);
+    void **churn_objs = malloc(sizeof(void *) * CHURN_WINDOW * threads);
+    size_t *churn_sizes = malloc(sizeof(size_t) * CHURN_WINDOW * threads);
+    footprint_t fp = {PTHREAD_MUTEX_INITIALIZER, workers, threads, 0, 0};
+    pthread_barrier_t start;
+    if ((a->create != sys_create && !shared) || !rings || !lat || !churn_objs || !churn_sizes) return;
+    // Pre-touch the harness memory so it is not counted as allocator growth.
+    memset(rings, 0, (threads / 2 + 1) * sizeof(spsc_ring_t));
+    memset(lat, 0, sizeof(double) * LAT_SAMPLES_PER_THREAD * threads);
+    memset(churn_objs, 0, sizeof(void *) * CHURN_WINDOW * threads);
+    memset(churn_sizes, 0, sizeof(size_t) * CHURN_WINDOW * threads);
+    pthread_barrier_init(&start, NULL, threads + 1);
+
+    for (int t = 0; t < threads; t++) {
+        workers[t] = (alloc_worker_t){
+            .a = a, .shared = shared, .tid = t, .scenario = scenario,
+            .ring = &rings[t / 2], .start = &start,
+            .lat = lat + (size_t)t * LAT_SAMPLES_PER_THREAD,
+            .churn_objs = churn_objs + (size_t)t * CHURN_WINDOW,
+            .churn_sizes = churn_sizes + (size_t)t * CHURN_WINDOW,
+            .fp = &fp,
+        };
+    }
+    for (int t = 0; t < threads; t++) pthread_create(&tids[t], NULL, alloc_worker, &workers[t]);
+    // Baseline once the threads (stacks, allocator contexts) are up.
+    pthread_barrier_wait(&start);
+    long rss_before = read_status_kb("VmRSS");
+    long file_before = read_status_kb("RssFile");
+    long anon_before = read_status_kb("RssAnon");
+    pthread_barrier_wait(&start);
+    double t0 = bench_now_ns();
+    for (int t = 0; t < threads; t++) pthread_join(tids[t], NULL);
+    double elapsed = bench_now_ns() - t0;
+
+    int producers = scenario == SCEN_XTHREAD ? threads / 2 : threads;
+    int n = 0;
+    double probe_ns = 0;
+    for (int t = 0; t < threads; t++) {
+        memmove(lat + n, workers[t].lat, sizeof(double) * workers[t].lat_n);
+        n += workers[t].lat_n;
+        res->failures += workers[t].failures;
+        if (workers[t].probe_ns > probe_ns) probe_ns = workers[t].probe_ns;
+    }
+    bench_stats_compute(lat, n, &res->lat);
+
+    res->ops_per_sec = (double)producers * ALLOC_OPS_PER_THREAD / ((elapsed - probe_ns) / 1e9);
+    // Code pages faulted in after fork() are file-backed, not allocator growth.
+    res->rss_growth_kb = read_status_kb("VmHWM") - rss_before - (read_status_kb("RssFile") - file_before);
+    res->fragmentation = fp.live ? ((fp.rss_kb - anon_before) * 1024.0) / fp.live : 0;
+    res->ok = 1;
+}
+
+static int run_cell_isolated(const allocator_t *a, int scenario, int threads, alloc_result_t *res) {
+    int fds[2];
+    if (pipe(fds)) return -1;
+    fflush(stdout);
+    pid_t pid = fork();
+    if (pid == 0) {
+        close(fds[0]);
+        run_cell(a, scenario, threads, res);
+        if (write(fds[1], res, sizeof(*res)) != sizeof(*res)) _exit(1);
+        _exit(0);
+    }
+    close(fds[1]);
+    int got = pid > 0 && read(fds[0], res, sizeof(*res)) == sizeof(*res);
+    close(fds[0]);
+    if (pid > 0) waitpid(pid, NULL, 0);
+    return got && res->ok ? 0 : -1;
+}
+
+/**
+ * @brief Compares glibc malloc (or an LD_PRELOADed allocator) with built-in
+ *        bump arena, fixed-size pool and per-thread slab allocators.
+ * @details Scenarios: "batch" frees 64 objects together (request lifetime),
+ *          "churn" replaces random objects in a 4096-entry live set, and
+ *          "xthread" allocates on one thread and frees on another.
+ *          Each cell runs in a forked child. RSS+ is its peak RSS growth
+ *          (VmHWM); fragmentation is the anonymous RSS growth at the
+ *          largest live set seen divided by the live bytes at that moment.
+ */
+void run_allocator_benchmark(FILE *log_fp, int max_threads) {
+    fprintf(log_fp, "\n[Part D: Allocator Performance]\n");
+    printf("\nRunning Allocator Benchmark...\n");
+
+    const char *preload = getenv("LD_PRELOAD");
+    if (preload && *preload) {
+        fprintf(log_fp, "malloc = LD_PRELOAD %s\n", preload);
+        printf("malloc = LD_PRELOAD %s\n", preload);
+    }
+    if (max_threads > ALLOC_MAX_THREADS) max_threads = ALLOC_MAX_THREADS;
+    if (max_threads < 1) max_threads = 1;
+
+    timer_overhead_ns = calibrate_timer();
+    fprintf(log_fp, "Timer overhead %.0f ns, subtracted from the latencies\n", timer_overhead_ns);
+
+    fprintf(log_fp, "%-8s %-8s %3s %12s %10s %10s %10s %10s %6s\n",
+            "Alloc", "Scenario", "Thr", "Mops/s", "p50(ns)", "p99(ns)", "max(ns)", "RSS+(KB)", "Frag");
+
+    for (size_t i = 0; i < sizeof(allocators) / sizeof(allocators[0]); i++) {
+        const allocator_t *a = &allocators[i];
+        for (int s = 0; s < SCEN_COUNT; s++) {
+            if (a->request_scoped_only && s != SCEN_BATCH) continue;
+            for (int t = (s == SCEN_XTHREAD) ? 2 : 1; t <= max_threads; t += (s == SCEN_XTHREAD) ? 2 : 1) {
+                alloc_result_t r;
+                if (run_cell_isolated(a, s, t, &r) != 0) {
+                    fprintf(log_fp, "%-8s %-8s %3d  failed\n", a->name, scenario_names[s], t);
+                    continue;
+                }
+                fprintf(log_fp, "%-8s %-8s %3d %12.2f %10.0f %10.0f %10.0f %10ld %6.2f%s\n",
+                        a->name, scenario_names[s], t, r.ops_per_sec / 1e6,
+                        r.lat.median, r.lat.p99, r.lat.max, r.rss_growth_kb, r.fragmentation,
+                        r.failures ? " (alloc failures)" : "");
+                printf("%-6s %-8s %dT: %7.2f Mops/s | p99 %6.0f ns | RSS +%ld KB\n",
+                       a->name, scenario_names[s], t, r.ops_per_sec / 1e6, r.lat.p99, r.rss_growth_kb);
+            }
+        }
+    }
+}
@@ -0,0 +1,14 @@
+#ifndef ALLOC_BENCH_H
+#define ALLOC_BENCH_H
+
+#include <stdio.h>
+
+/**
+ * @brief Compares glibc malloc (or an LD_PRELOADed allocator) with built-in
+ *        bump arena, fixed-size pool and per-thread slab allocators.
+ * @param log_fp Pointer to the hardware_info.txt file.
+ * @param max_threads Highest thread count to sweep (capped at 4).
+ */
+void run_allocator_benchmark(FILE *log_fp, int max_threads);
+
+#endif
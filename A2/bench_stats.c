@@ -0,0 +1,76 @@
+#include <stdlib.h>
+#include <math.h>
+#include <time.h>
+
+#include "bench_stats.h"
+
+#define BENCH_MAX_SAMPLES 1024
+
+/**
+ * @brief Returns CLOCK_MONOTONIC in nanoseconds.
+ */
+double bench_now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000000000.0 + ts.tv_nsec;
+}
+
+static int cmp_double(const void *a, const void *b) {
+    double x = *(const double *)a, y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+/**
+ * @brief Reduces raw samples to min/median/mean/p99/max/stddev.
+ */
+void bench_stats_compute(double *samples, int n, bench_stats_t *out) {
+    out->samples = n;
+    if (n <= 0) {
+        out->min = out->median = out->mean = out->p99 = out->max = out->stddev = 0;
+        return;
+    }
+
+    qsort(samples, n, sizeof(double), cmp_double);
+
+    double sum = 0;
+    for (int i = 0; i < n; i++) sum += samples[i];
+    double mean = sum / n;
+
+    double var = 0;
+    for (int i = 0; i < n; i++) var += (samples[i] - mean) * (samples[i] - mean);
+
+    out->min = samples[0];
+    out->max = samples[n - 1];
+    out->mean = mean;
+    out->median = (n % 2) ? samples[n / 2] : (samples[n / 2 - 1] + samples[n / 2]) / 2.0;
+    out->p99 = samples[(int)ceil(0.99 * n) - 1];
+    out->stddev = n > 1 ? sqrt(var / (n - 1)) : 0;
+}
+
+/**
+ * @brief Times @p fn over @p samples runs of @p iterations operations each.
+ */
+void bench_measure(bench_fn_t fn, void *ctx, long iterations, int samples, bench_stats_t *out) {
+    double raw[BENCH_MAX_SAMPLES];
+    if (samples > BENCH_MAX_SAMPLES) samples = BENCH_MAX_SAMPLES;
+    if (iterations < 1) iterations = 1;
+
+    fn(ctx, iterations);
+
+    for (int s = 0; s < samples; s++) {
+        double t0 = bench_now_ns();
+        fn(ctx, iterations);
+        raw[s] = (bench_now_ns() - t0) / iterations;
+    }
+    bench_stats_compute(raw, samples, out);
+}
+
+/**
+ * @brief Writes one summary row to the report and mirrors it on stdout.
+ */
+void bench_stats_log(FILE *log_fp, const char *label, const char *unit, const bench_stats_t *st) {
+    fprintf(log_fp, "%-32s: median %10.1f %s | min %10.1f | p99 %10.1f | sd %8.1f (n=%d)\n",
+            label, st->median, unit, st->min, st->p99, st->stddev, st->samples);
+    printf("%-32s: median %10.1f %s | min %10.1f | p99 %10.1f\n",
+           label, st->median, unit, st->min, st->p99);
+}
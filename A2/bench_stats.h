@@ -0,0 +1,50 @@
+#ifndef BENCH_STATS_H
+#define BENCH_STATS_H
+
+#include <stdio.h>
+
+/**
+ * @brief Summary of a set of repeated timing samples.
+ * @details All values share the unit of the input samples (usually ns/op).
+ */
+typedef struct {
+    int samples;
+    double min;
+    double median;
+    double mean;
+    double p99;
+    double max;
+    double stddev;
+} bench_stats_t;
+
+/**
+ * @brief Body of a timed operation; runs the measured work @p iterations times.
+ */
+typedef void (*bench_fn_t)(void *ctx, long iterations);
+
+/**
+ * @brief Returns CLOCK_MONOTONIC in nanoseconds.
+ */
+double bench_now_ns(void);
+
+/**
+ * @brief Reduces raw samples to min/median/mean/p99/max/stddev.
+ * @param samples Sample array; sorted in place.
+ * @param n Number of samples.
+ * @param out Destination summary.
+ */
+void bench_stats_compute(double *samples, int n, bench_stats_t *out);
+
+/**
+ * @brief Times @p fn over @p samples runs of @p iterations operations each.
+ * @details One untimed warm-up run precedes the measurement. Each sample is
+ *          the per-operation cost in nanoseconds.
+ */
+void bench_measure(bench_fn_t fn, void *ctx, long iterations, int samples, bench_stats_t *out);
+
+/**
+ * @brief Writes one summary row to the report and mirrors it on stdout.
+ */
+void bench_stats_log(FILE *log_fp, const char *label, const char *unit, const bench_stats_t *st);
+
+#endif
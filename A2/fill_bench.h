@@ -0,0 +1,13 @@
+#ifndef FILL_BENCH_H
+#define FILL_BENCH_H
+
+#include <stdio.h>
+
+/**
+ * @brief Write-path benchmark: memset, scalar/vector stores, DC ZVA,
+ *        non-temporal stores and calloc/MADV_DONTNEED zeroing.
+ * @param log_fp Pointer to the hardware_info.txt file.
+ */
+void run_fill_benchmark(FILE *log_fp);
+
+#endif
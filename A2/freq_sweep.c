@@ -0,0 +1,330 @@
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <sched.h>
+#include <math.h>
+
+#include "bench_stats.h"
+#include "kernels.h"
+#include "freq_sweep.h"
+
+#define FREQ_MAX_POINTS 32
+#define FREQ_FALLBACK_POINTS 5   // min..max when scaling_available_frequencies is missing
+#define FREQ_SAMPLES 5
+#define FREQ_SMALL_BYTES (16 * 1024)
+#define FREQ_LARGE_BYTES (64 * 1024 * 1024)
+#define FREQ_SETTLE_US 100000
+#define FREQ_KEEP_FRACTION 0.95  // cap = lowest frequency keeping this share of the peak
+#define FREQ_CLOCK_BOUND 0.8     // scaling exponent above this is clock-bound
+#define FREQ_MEMORY_BOUND 0.3    // and below this memory-bound
+
+enum { ATTR_GOVERNOR, ATTR_MIN, ATTR_MAX, ATTR_COUNT };
+
+typedef struct {
+    char path[160];
+    char value[32];
+} sysfs_attr_t;
+
+/*
+ * Saved cpufreq state. freq_restore() runs from signal handlers, so it
+ * only uses open/write/close on paths prepared in advance.
+ */
+static sysfs_attr_t g_saved[ATTR_COUNT];
+static volatile sig_atomic_t g_have_saved;
+static const int g_signals[] = {SIGINT, SIGTERM, SIGHUP, SIGQUIT};
+#define SIGNAL_COUNT ((int)(sizeof(g_signals) / sizeof(g_signals[0])))
+static struct sigaction g_old_actions[SIGNAL_COUNT];
+
+typedef struct {
+    const char *name;
+    kernel_op_t op;
+    size_t bytes; // 0 = dependent integer chain, reported in Mops/s
+} sweep_kernel_t;
+
+static const sweep_kernel_t sweep_kernels[] = {
+    {"int-chain", KERNEL_COPY, 0},
+    {"copy-16K", KERNEL_COPY, FREQ_SMALL_BYTES},
+    {"add32-16K", KERNEL_ADD_U32, FREQ_SMALL_BYTES},
+    {"add64-16K", KERNEL_ADD_U64, FREQ_SMALL_BYTES},
+    {"copy-64M", KERNEL_COPY, FREQ_LARGE_BYTES},
+    {"add32-64M", KERNEL_ADD_U32, FREQ_LARGE_BYTES},
+    {"add64-64M", KERNEL_ADD_U64, FREQ_LARGE_BYTES},
+};
+#define SWEEP_KERNEL_COUNT ((int)(sizeof(sweep_kernels) / sizeof(sweep_kernels[0])))
+
+static int read_attr(const char *name, char *buf, size_t size) {
+    char path[160];
+    snprintf(path, sizeof(path), "%s/%s", CPUFREQ_POLICY, name);
+    FILE *fp = fopen(path, "r");
+    if (!fp) return -1;
+    if (!fgets(buf, (int)size, fp)) buf[0] = '\0';
+    fclose(fp);
+    buf[strcspn(buf, "\n")] = '\0';
+    return 0;
+}
+
+/**
+ * @brief Writes @p value to a sysfs file; async-signal-safe.
+ */
+static int write_path(const char *path, const char *value) {
+    int fd = open(path, O_WRONLY | O_TRUNC);
+    if (fd < 0) return -1;
+    ssize_t len = (ssize_t)strlen(value);
+    ssize_t n = write(fd, value, len);
+    close(fd);
+    return n == len ? 0 : -1;
+}
+
+static int write_attr(const char *name, const char *value) {
+    char path[160];
+    snprintf(path, sizeof(path), "%s/%s", CPUFREQ_POLICY, name);
+    return write_path(path, value);
+}
+
+static int write_attr_khz(const char *name, long khz) {
+    char value[32];
+    snprintf(value, sizeof(value), "%ld", khz);
+    return write_attr(name, value);
+}
+
+/**
+ * @brief Puts back the governor and limits saved by freq_save().
+ * @details min is written on both sides of max so the pair is accepted
+ *          whichever way the pinned frequency moved.
+ */
+static void freq_restore(void) {
+    if (!g_have_saved) return;
+    g_have_saved = 0;
+    write_path(g_saved[ATTR_GOVERNOR].path, g_saved[ATTR_GOVERNOR].value);
+    write_path(g_saved[ATTR_MIN].path, g_saved[ATTR_MIN].value);
+    write_path(g_saved[ATTR_MAX].path, g_saved[ATTR_MAX].value);
+    write_path(g_saved[ATTR_MIN].path, g_saved[ATTR_MIN].value);
+}
+
+static void freq_signal_handler(int sig) {
+    freq_restore();
+    signal(sig, SIG_DFL);
+    raise(sig);
+}
+
+static int freq_save(void) {
+    static const char *names[ATTR_COUNT] = {"scaling_governor", "scaling_min_freq", "scaling_max_freq"};
+    static int atexit_registered;
+
+    for (int i = 0; i < ATTR_COUNT; i++) {
+        snprintf(g_saved[i].path, sizeof(g_saved[i].path), "%s/%s", CPUFREQ_POLICY, names[i]);
+        if (read_attr(names[i], g_saved[i].value, sizeof(g_saved[i].value)) != 0) return -1;
+    }
+    g_have_saved = 1;
+
+    if (!atexit_registered) {
+        atexit(freq_restore);
+        atexit_registered = 1;
+    }
+    struct sigaction sa;
+    memset(&sa, 0, sizeof(sa));
+    sa.sa_handler = freq_signal_handler;
+    sigemptyset(&sa.sa_mask);
+    for (int i = 0; i < SIGNAL_COUNT; i++) sigaction(g_signals[i], &sa, &g_old_actions[i]);
+    return 0;
+}
+
+static void freq_release(void) {
+    freq_restore();
+    for (int i = 0; i < SIGNAL_COUNT; i++) sigaction(g_signals[i], &g_old_actions[i], NULL);
+}
+
+static int compare_long(const void *a, const void *b) {
+    long x = *(const long *)a, y = *(const long *)b;
+    return (x > y) - (x < y);
+}
+
+/**
+ * @brief Reads the frequency table in kHz, ascending. Without
+ *        scaling_available_frequencies (e.g. intel_pstate) the range
+ *        cpuinfo_min_freq..cpuinfo_max_freq is split evenly.
+ */
+static int read_frequencies(long *khz, int max_points) {
+    char buf[512], *tok, *save;
+    int n = 0;
+
+    if (read_attr("scaling_available_frequencies", buf, sizeof(buf)) == 0) {
+        for (tok = strtok_r(buf, " ", &save); tok && n < max_points; tok = strtok_r(NULL, " ", &save))
+            if (atol(tok) > 0) khz[n++] = atol(tok);
+    }
+    if (n == 0) {
+        char lo[32], hi[32];
+        if (read_attr("cpuinfo_min_freq", lo, sizeof(lo)) != 0 || read_attr("cpuinfo_max_freq", hi, sizeof(hi)) != 0)
+            return 0;
+        for (int i = 0; i < FREQ_FALLBACK_POINTS; i++)
+            khz[n++] = atol(lo) + (atol(hi) - atol(lo)) * i / (FREQ_FALLBACK_POINTS - 1);
+    }
+    qsort(khz, n, sizeof(long), compare_long);
+    return n;
+}
+
+/**
+ * @brief Pins the policy to @p khz, through scaling_setspeed when the
+ *        userspace governor is in use, else by clamping min = max.
+ */
+static int set_frequency(long khz, int userspace, long floor_khz) {
+    if (userspace) return write_attr_khz("scaling_setspeed", khz);
+    if (write_attr_khz("scaling_min_freq", floor_khz) != 0) return -1;
+    if (write_attr_khz("scaling_max_freq", khz) != 0) return -1;
+    return write_attr_khz("scaling_min_freq", khz);
+}
+
+typedef struct {
+    const sweep_kernel_t *k;
+    uint8_t *dst, *a, *b;
+    uint64_t chain;
+} sweep_ctx_t;
+
+static void sweep_body(void *ctx, long iterations) {
+    sweep_ctx_t *s = (sweep_ctx_t *)ctx;
+    if (s->k->bytes == 0) {
+        // Dependent multiply-add: pure core latency, scales 1:1 with the clock.
+        uint64_t x = s->chain;
+        for (long i = 0; i < iterations; i++) {
+            x = x * 3 + 1;
+            __asm__ volatile("" : "+r"(x));
+        }
+        s->chain = x;
+        return;
+    }
+    for (long i = 0; i < iterations; i++) {
+        kernel_run(s->k->op, s->dst, s->a, s->b, s->k->bytes);
+        __asm__ volatile("" : : "r"(s->dst) : "memory");
+    }
+}
+
+/**
+ * @brief Returns Mops/s for the chain and destination GB/s for kernels.
+ */
+static double measure_kernel(sweep_ctx_t *ctx) {
+    bench_stats_t st;
+    if (ctx->k->bytes == 0) {
+        bench_measure(sweep_body, ctx, 1000000, FREQ_SAMPLES, &st);
+        return 1e3 / st.median;
+    }
+    long iterations = FREQ_LARGE_BYTES / ctx->k->bytes;
+    bench_measure(sweep_body, ctx, iterations, FREQ_SAMPLES, &st);
+    return ctx->k->bytes / st.median;
+}
+
+/**
+ * @brief Pins CPU0 to each available frequency in turn and runs the kernel
+ *        library at cache- and DRAM-sized buffers (Part H).
+ * @details The scaling exponent is d log(throughput) / d log(frequency)
+ *          between the lowest and highest point: ~1 means clock-bound, ~0
+ *          memory-bound. The suggested cap is the lowest frequency that
+ *          still reaches FREQ_KEEP_FRACTION of the kernel's best result.
+ */
+void run_freq_sweep(FILE *log_fp) {
+    long khz[FREQ_MAX_POINTS], cur_khz[FREQ_MAX_POINTS];
+    static double perf[SWEEP_KERNEL_COUNT][FREQ_MAX_POINTS];
+    char governors[256], buf[32];
+    cpu_set_t old_mask, cpu0;
+
+    fprintf(log_fp, "\n[Part H: CPU Frequency Sweep]\n");
+    printf("\nRunning CPU Frequency Sweep...\n");
+
+    int points = read_frequencies(khz, FREQ_MAX_POINTS);
+    if (points < 2) {
+        fprintf(log_fp, "cpufreq not available at %s; sweep skipped\n", CPUFREQ_POLICY);
+        return;
+    }
+    if (freq_save() != 0) {
+        fprintf(log_fp, "Cannot read cpufreq governor/limits; sweep skipped\n");
+        return;
+    }
+
+    int userspace = read_attr("scaling_available_governors", governors, sizeof(governors)) == 0 &&
+                    strstr(governors, "userspace") != NULL;
+    if (userspace && write_attr("scaling_governor", "userspace") != 0) userspace = 0;
+    if (set_frequency(khz[0], userspace, khz[0]) != 0) {
+        fprintf(log_fp, "cpufreq not writable (needs root); sweep skipped\n");
+        printf("cpufreq not writable (needs root); sweep skipped\n");
+        freq_release();
+        return;
+    }
+    fprintf(log_fp, "Governor %s, pinned via %s, %d points\n", g_saved[ATTR_GOVERNOR].value,
+            userspace ? "userspace/scaling_setspeed" : "scaling_min_freq = scaling_max_freq", points);
+
+    uint8_t *dst = aligned_alloc(64, FREQ_LARGE_BYTES);
+    uint8_t *a = aligned_alloc(64, FREQ_LARGE_BYTES);
+    uint8_t *b = aligned_alloc(64, FREQ_LARGE_BYTES);
+    if (!dst || !a || !b) {
+        free(dst);
+        free(a);
+        free(b);
+        freq_release();
+        return;
+    }
+    memset(dst, 0, FREQ_LARGE_BYTES);
+    memset(a, 1, FREQ_LARGE_BYTES);
+    memset(b, 2, FREQ_LARGE_BYTES);
+
+    sched_getaffinity(0, sizeof(old_mask), &old_mask);
+    CPU_ZERO(&cpu0);
+    CPU_SET(0, &cpu0);
+    sched_setaffinity(0, sizeof(cpu0), &cpu0);
+
+    for (int p = 0; p < points; p++) {
+        set_frequency(khz[p], userspace, khz[0]);
+        usleep(FREQ_SETTLE_US);
+        for (int k = 0; k < SWEEP_KERNEL_COUNT; k++) {
+            sweep_ctx_t ctx = {&sweep_kernels[k], dst, a, b, 1};
+            perf[k][p] = measure_kernel(&ctx);
+        }
+        cur_khz[p] = read_attr("scaling_cur_freq", buf, sizeof(buf)) == 0 ? atol(buf) : khz[p];
+        printf("%5ld MHz (cur %5ld): chain %.1f Mops/s, copy-64M %.2f GB/s\n", khz[p] / 1000, cur_khz[p] / 1000,
+               perf[0][p], perf[4][p]);
+    }
+
+    sched_setaffinity(0, sizeof(old_mask), &old_mask);
+    freq_release();
+    free(dst);
+    free(a);
+    free(b);
+
+    fprintf(log_fp, "%9s %9s", "Set(MHz)", "Cur(MHz)");
+    for (int k = 0; k < SWEEP_KERNEL_COUNT; k++) fprintf(log_fp, " %10s", sweep_kernels[k].name);
+    fprintf(log_fp, "\n%19s %10s", "", "Mops/s");
+    for (int k = 1; k < SWEEP_KERNEL_COUNT; k++) fprintf(log_fp, " %10s", "GB/s");
+    fprintf(log_fp, "\n");
+    for (int p = 0; p < points; p++) {
+        fprintf(log_fp, "%9ld %9ld", khz[p] / 1000, cur_khz[p] / 1000);
+        for (int k = 0; k < SWEEP_KERNEL_COUNT; k++) fprintf(log_fp, " %10.2f", perf[k][p]);
+        fprintf(log_fp, "\n");
+    }
+
+    fprintf(log_fp, "\n%-10s %8s %-13s %12s\n", "Kernel", "Scaling", "Bound", "Cap(MHz)");
+    double freq_ratio = log((double)cur_khz[points - 1] / cur_khz[0]);
+    for (int k = 0; k < SWEEP_KERNEL_COUNT; k++) {
+        double best = 0;
+        for (int p = 0; p < points; p++)
+            if (perf[k][p] > best) best = perf[k][p];
+        int cap = points - 1;
+        for (int p = 0; p < points; p++)
+            if (perf[k][p] >= FREQ_KEEP_FRACTION * best) {
+                cap = p;
+                break;
+            }
+
+        if (freq_ratio > 0 && perf[k][0] > 0) {
+            double scaling = log(perf[k][points - 1] / perf[k][0]) / freq_ratio;
+            const char *bound = scaling >= FREQ_CLOCK_BOUND ? "clock-bound"
+                                : scaling <= FREQ_MEMORY_BOUND ? "memory-bound" : "mixed";
+            fprintf(log_fp, "%-10s %8.2f %-13s %12ld\n", sweep_kernels[k].name, scaling, bound, khz[cap] / 1000);
+        } else {
+            // The clock never moved (firmware override or throttling).
+            fprintf(log_fp, "%-10s %8s %-13s %12ld\n", sweep_kernels[k].name, "n/a", "n/a", khz[cap] / 1000);
+        }
+    }
+}
@@ -0,0 +1,21 @@
+#ifndef FREQ_SWEEP_H
+#define FREQ_SWEEP_H
+
+#include <stdio.h>
+
+#ifndef CPUFREQ_POLICY
+#define CPUFREQ_POLICY "/sys/devices/system/cpu/cpufreq/policy0"
+#endif
+
+/**
+ * @brief Pins CPU0 to each available frequency in turn and runs the kernel
+ *        library at cache- and DRAM-sized buffers (Part H).
+ * @details Needs write access to cpufreq sysfs (root). Uses the userspace
+ *          governor when available, otherwise scaling_min_freq = max_freq.
+ *          The original governor and limits are restored on return, on
+ *          exit() and on SIGINT/SIGTERM/SIGHUP/SIGQUIT.
+ * @param log_fp Pointer to the hardware_info.txt file.
+ */
+void run_freq_sweep(FILE *log_fp);
+
+#endif
@@ -0,0 +1,500 @@
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <linux/perf_event.h>
+
+#include "bench_stats.h"
+#include "perf_counters.h"
+#include "frontend_bench.h"
+
+#define FE_SAMPLES 5
+#define FE_INSNS_PER_SAMPLE (8L * 1024 * 1024) // generated instructions executed per timed sample
+#define FE_PAGE 4096
+#define FE_LINE 64
+#define FE_MAX_FOOTPRINT (8 * 1024 * 1024)
+#define FE_MAX_PAGES 4096
+#define BRANCH_PATTERN_LEN 65536
+#define BRANCH_MAX_PERIOD 16384
+#define INDIRECT_SEQ_LEN 4096
+#define INDIRECT_MAX_TARGETS 64
+
+/*
+ * Code generator. Emits straight-line "add reg, reg, reg" on four
+ * caller-saved registers, unconditional jumps and a return, so the same
+ * footprint can be produced on the Pi (A64) and on an x86-64 dev box.
+ */
+#if defined(__aarch64__)
+#define JIT_SUPPORTED 1
+#define JIT_ADD_BYTES 4
+#define JIT_RET_BYTES 4
+#elif defined(__x86_64__)
+#define JIT_SUPPORTED 1
+#define JIT_ADD_BYTES 3
+#define JIT_RET_BYTES 1
+#else
+#define JIT_SUPPORTED 0
+#endif
+
+#if JIT_SUPPORTED
+
+typedef uint64_t (*jit_fn_t)(void);
+
+typedef struct {
+    uint8_t *mem;
+    size_t size;
+    uint8_t *pos;
+    long insns; // instructions executed by one call
+} jit_code_t;
+
+#if defined(__aarch64__)
+static void emit32(jit_code_t *j, uint32_t v) {
+    memcpy(j->pos, &v, 4);
+    j->pos += 4;
+}
+#endif
+
+/**
+ * @brief Emits a register-register add; the immediate form is folded at
+ *        rename on some x86 cores and would not give 1 cycle per link.
+ */
+static void jit_emit_add(jit_code_t *j, int reg) {
+#if defined(__aarch64__)
+    emit32(j, 0x8B000000u | (reg << 16) | (reg << 5) | reg); // add xN, xN, xN
+#elif defined(__x86_64__)
+    static const uint8_t regs[4] = {0, 1, 2, 6}; // rax, rcx, rdx, rsi
+    j->pos[0] = 0x48; // add r64, r64
+    j->pos[1] = 0x01;
+    j->pos[2] = 0xC0 | (regs[reg] << 3) | regs[reg];
+    j->pos += 3;
+#endif
+    j->insns++;
+}
+
+static void jit_emit_jump(jit_code_t *j, const uint8_t *target) {
+#if defined(__aarch64__)
+    emit32(j, 0x14000000u | ((uint32_t)((target - j->pos) >> 2) & 0x3FFFFFFu)); // b target
+#elif defined(__x86_64__)
+    int32_t rel = (int32_t)(target - (j->pos + 5)); // jmp rel32
+    j->pos[0] = 0xE9;
+    memcpy(j->pos + 1, &rel, 4);
+    j->pos += 5;
+#endif
+    j->insns++;
+}
+
+static void jit_emit_ret(jit_code_t *j) {
+#if defined(__aarch64__)
+    emit32(j, 0xD65F03C0u);
+#elif defined(__x86_64__)
+    *j->pos++ = 0xC3;
+#endif
+    j->insns++;
+}
+
+static int jit_alloc(jit_code_t *j, size_t size) {
+    j->size = (size + FE_PAGE - 1) & ~(size_t)(FE_PAGE - 1);
+    j->mem = mmap(NULL, j->size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (j->mem == MAP_FAILED) return -1;
+    j->pos = j->mem;
+    j->insns = 0;
+    return 0;
+}
+
+/**
+ * @brief Flips the buffer to read+execute and syncs the I-cache with the
+ *        stores that wrote it (required on Arm).
+ */
+static int jit_finish(jit_code_t *j) {
+    if (mprotect(j->mem, j->size, PROT_READ | PROT_EXEC) != 0) return -1;
+    __builtin___clear_cache((char *)j->mem, (char *)j->mem + j->size);
+    return 0;
+}
+
+static void jit_free(jit_code_t *j) {
+    munmap(j->mem, j->size);
+}
+
+/**
+ * @brief Straight-line code of @p bytes: adds spread over @p chains
+ *        independent registers, then a return.
+ */
+static int jit_build_linear(jit_code_t *j, size_t bytes, int chains) {
+    if (jit_alloc(j, bytes) != 0) return -1;
+    long n = (long)((bytes - JIT_RET_BYTES) / JIT_ADD_BYTES);
+    for (long i = 0; i < n; i++) jit_emit_add(j, (int)(i % chains));
+    jit_emit_ret(j);
+    return jit_finish(j);
+}
+
+/**
+ * @brief One small block per page, each ending in a jump to the next page.
+ *        Blocks move one line further into their page so they do not all
+ *        land in the same I-cache set; the I-cache footprint stays small
+ *        while the number of distinct code pages grows.
+ */
+static int jit_build_page_chain(jit_code_t *j, int pages) {
+    if (jit_alloc(j, (size_t)pages * FE_PAGE) != 0) return -1;
+    for (int i = 0; i < pages; i++) {
+        j->pos = j->mem + (size_t)i * FE_PAGE + (i % (FE_PAGE / FE_LINE)) * FE_LINE;
+        for (int r = 0; r < 4; r++) jit_emit_add(j, r);
+        if (i == pages - 1)
+            jit_emit_ret(j);
+        else
+            jit_emit_jump(j, j->mem + (size_t)(i + 1) * FE_PAGE + ((i + 1) % (FE_PAGE / FE_LINE)) * FE_LINE);
+    }
+    return jit_finish(j);
+}
+
+typedef struct {
+    jit_fn_t fn;
+    uint64_t sink;
+} jit_ctx_t;
+
+static void jit_body(void *ctx, long iterations) {
+    jit_ctx_t *c = (jit_ctx_t *)ctx;
+    uint64_t s = 0;
+    for (long i = 0; i < iterations; i++) s += c->fn();
+    c->sink = s;
+}
+#endif
+
+/*
+ * Conditional branches. The empty asm statements differ so the compiler
+ * can neither merge the two arms nor turn the branch into a csel/cmov.
+ */
+typedef struct {
+    const uint8_t *pattern;
+    long n;
+    uint64_t sink;
+} branch_ctx_t;
+
+static void branch_body(void *ctx, long iterations) {
+    branch_ctx_t *b = (branch_ctx_t *)ctx;
+    uint64_t s = b->sink;
+    for (long it = 0; it < iterations; it++) {
+        for (long i = 0; i < b->n; i++) {
+            if (b->pattern[i]) {
+                __asm__ volatile("" : "+r"(s));
+                s += i;
+            } else {
+                __asm__ volatile("" : "+r"(s) : "r"(i));
+                s ^= i;
+            }
+        }
+    }
+    b->sink = s;
+}
+
+/*
+ * Indirect calls: 64 distinct targets reached through a function table.
+ */
+#define IND_TARGET(hi, lo)                                                   \
+    static __attribute__((noinline)) uint64_t ind_target_##hi##_##lo(uint64_t x) { \
+        __asm__ volatile("" : "+r"(x));                                      \
+        return x + (hi) * 8 + (lo);                                          \
+    }
+#define IND_TARGET_ROW(hi)                                                   \
+    IND_TARGET(hi, 0) IND_TARGET(hi, 1) IND_TARGET(hi, 2) IND_TARGET(hi, 3)  \
+    IND_TARGET(hi, 4) IND_TARGET(hi, 5) IND_TARGET(hi, 6) IND_TARGET(hi, 7)
+#define IND_REF_ROW(hi)                                                      \
+    ind_target_##hi##_0, ind_target_##hi##_1, ind_target_##hi##_2, ind_target_##hi##_3, \
+    ind_target_##hi##_4, ind_target_##hi##_5, ind_target_##hi##_6, ind_target_##hi##_7
+
+IND_TARGET_ROW(0) IND_TARGET_ROW(1) IND_TARGET_ROW(2) IND_TARGET_ROW(3)
+IND_TARGET_ROW(4) IND_TARGET_ROW(5) IND_TARGET_ROW(6) IND_TARGET_ROW(7)
+
+static uint64_t (*const ind_targets[INDIRECT_MAX_TARGETS])(uint64_t) = {
+    IND_REF_ROW(0), IND_REF_ROW(1), IND_REF_ROW(2), IND_REF_ROW(3),
+    IND_REF_ROW(4), IND_REF_ROW(5), IND_REF_ROW(6), IND_REF_ROW(7),
+};
+
+typedef struct {
+    const uint8_t *seq;
+    uint64_t sink;
+} indirect_ctx_t;
+
+static void indirect_body(void *ctx, long iterations) {
+    indirect_ctx_t *c = (indirect_ctx_t *)ctx;
+    uint64_t s = c->sink;
+    for (long it = 0; it < iterations; it++)
+        for (int i = 0; i < INDIRECT_SEQ_LEN; i++) s = ind_targets[c->seq[i]](s);
+    c->sink = s;
+}
+
+/*
+ * PMU events. Each is opened on its own; any of them may be missing.
+ */
+#define HW_CACHE_READ_MISS(cache) \
+    ((cache) | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16))
+
+enum { EV_CYCLES, EV_INSNS, EV_BRANCH_MISSES, EV_L1I_MISSES, EV_ITLB_MISSES, EV_COUNT };
+
+typedef struct {
+    perf_counter_t pc[EV_COUNT];
+    uint64_t count[EV_COUNT];
+} fe_counters_t;
+
+static void fe_counters_open(fe_counters_t *c) {
+    perf_counter_open(&c->pc[EV_CYCLES], PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES);
+    perf_counter_open(&c->pc[EV_INSNS], PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS);
+    perf_counter_open(&c->pc[EV_BRANCH_MISSES], PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES);
+    perf_counter_open(&c->pc[EV_L1I_MISSES], PERF_TYPE_HW_CACHE, HW_CACHE_READ_MISS(PERF_COUNT_HW_CACHE_L1I));
+    perf_counter_open(&c->pc[EV_ITLB_MISSES], PERF_TYPE_HW_CACHE, HW_CACHE_READ_MISS(PERF_COUNT_HW_CACHE_ITLB));
+}
+
+static void fe_counters_close(fe_counters_t *c) {
+    for (int e = 0; e < EV_COUNT; e++) perf_counter_close(&c->pc[e]);
+}
+
+static int fe_have(const fe_counters_t *c, int e) {
+    return c->pc[e].fd >= 0;
+}
+
+/**
+ * @brief One untimed pass of @p fn with all available counters running.
+ */
+static void fe_count(fe_counters_t *c, bench_fn_t fn, void *ctx, long iterations) {
+    for (int e = 0; e < EV_COUNT; e++) perf_counter_start(&c->pc[e]);
+    fn(ctx, iterations);
+    for (int e = EV_COUNT - 1; e >= 0; e--) c->count[e] = perf_counter_stop(&c->pc[e]);
+}
+
+/**
+ * @brief Writes a counter-derived column, or n/a when the event is missing.
+ */
+static void fe_log_col(FILE *log_fp, int have, double value) {
+    if (have)
+        fprintf(log_fp, " %12.3f", value);
+    else
+        fprintf(log_fp, " %12s", "n/a");
+}
+
+static double g_cycle_ns; // from a dependent add chain, 0 if unknown
+
+/**
+ * @brief CPI from cycle and instruction counters, else estimated from the
+ *        time per instruction and g_cycle_ns; 0 if neither is available.
+ */
+static double fe_cpi(const fe_counters_t *c, double ns_per_insn) {
+    if (fe_have(c, EV_CYCLES) && fe_have(c, EV_INSNS) && c->count[EV_INSNS] > 0)
+        return (double)c->count[EV_CYCLES] / c->count[EV_INSNS];
+    if (g_cycle_ns > 0) return ns_per_insn / g_cycle_ns;
+    return 0;
+}
+
+#if JIT_SUPPORTED
+static void run_code_footprint(FILE *log_fp, fe_counters_t *c) {
+    fprintf(log_fp, "\nCode footprint (straight-line adds, 4 independent chains):\n");
+    fprintf(log_fp, "%10s %10s %8s %12s %12s\n", "Size(KB)", "ns/insn", "CPI", "L1I miss/Ki", "iTLB miss/Ki");
+
+    for (size_t size = 1024; size <= FE_MAX_FOOTPRINT; size *= 2) {
+        jit_code_t j;
+        if (jit_build_linear(&j, size, 4) != 0) {
+            fprintf(log_fp, "%10zu cannot map executable memory\n", size / 1024);
+            return;
+        }
+        jit_ctx_t ctx = {(jit_fn_t)(void *)j.mem, 0};
+        long iterations = FE_INSNS_PER_SAMPLE / j.insns;
+        if (iterations < 1) iterations = 1;
+
+        bench_stats_t st;
+        bench_measure(jit_body, &ctx, iterations, FE_SAMPLES, &st);
+        double ns_insn = st.median / j.insns;
+        fe_count(c, jit_body, &ctx, iterations);
+        double kinsns = (double)j.insns * iterations / 1000.0;
+
+        fprintf(log_fp, "%10zu %10.3f %8.2f", size / 1024, ns_insn, fe_cpi(c, ns_insn));
+        fe_log_col(log_fp, fe_have(c, EV_L1I_MISSES), c->count[EV_L1I_MISSES] / kinsns);
+        fe_log_col(log_fp, fe_have(c, EV_ITLB_MISSES), c->count[EV_ITLB_MISSES] / kinsns);
+        fprintf(log_fp, "\n");
+        printf("code %6zuKB: %7.3f ns/insn\n", size / 1024, ns_insn);
+        jit_free(&j);
+    }
+}
+
+static void run_code_pages(FILE *log_fp, fe_counters_t *c) {
+    fprintf(log_fp, "\nCode pages (one 5-instruction block per 4KB page):\n");
+    fprintf(log_fp, "%10s %10s %8s %12s\n", "Pages", "ns/block", "CPI", "iTLB miss/blk");
+
+    for (int pages = 8; pages <= FE_MAX_PAGES; pages *= 2) {
+        jit_code_t j;
+        if (jit_build_page_chain(&j, pages) != 0) {
+            fprintf(log_fp, "%10d cannot map executable memory\n", pages);
+            return;
+        }
+        jit_ctx_t ctx = {(jit_fn_t)(void *)j.mem, 0};
+        long iterations = FE_INSNS_PER_SAMPLE / j.insns;
+
+        bench_stats_t st;
+        bench_measure(jit_body, &ctx, iterations, FE_SAMPLES, &st);
+        double ns_block = st.median / pages;
+        fe_count(c, jit_body, &ctx, iterations);
+
+        fprintf(log_fp, "%10d %10.3f %8.2f", pages, ns_block, fe_cpi(c, ns_block / 5));
+        fe_log_col(log_fp, fe_have(c, EV_ITLB_MISSES), (double)c->count[EV_ITLB_MISSES] / ((double)pages * iterations));
+        fprintf(log_fp, "\n");
+        printf("code %5d pages: %7.3f ns/block\n", pages, ns_block);
+        jit_free(&j);
+    }
+}
+#endif
+
+static uint32_t xorshift32(uint32_t *state) {
+    uint32_t x = *state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    return *state = x;
+}
+
+/**
+ * @brief Times one branch pattern; returns ns per branch and sets
+ *        @p misses to mispredicts per branch (-1 without a counter).
+ */
+static double measure_branch_pattern(fe_counters_t *c, const uint8_t *pattern, double *misses) {
+    branch_ctx_t ctx = {pattern, BRANCH_PATTERN_LEN, 0};
+    bench_stats_t st;
+    bench_measure(branch_body, &ctx, 4, FE_SAMPLES, &st);
+    fe_count(c, branch_body, &ctx, 4);
+    *misses = fe_have(c, EV_BRANCH_MISSES) ? c->count[EV_BRANCH_MISSES] / (4.0 * BRANCH_PATTERN_LEN) : -1;
+    return st.median / BRANCH_PATTERN_LEN;
+}
+
+static void log_branch_row(FILE *log_fp, const char *label, double ns, double misses) {
+    fprintf(log_fp, "%-16s %10.3f", label, ns);
+    fe_log_col(log_fp, misses >= 0, misses);
+    fprintf(log_fp, "\n");
+    printf("%-16s %7.3f ns/branch\n", label, ns);
+}
+
+static void run_branch_patterns(FILE *log_fp, fe_counters_t *c) {
+    uint8_t *pattern = malloc(BRANCH_PATTERN_LEN);
+    uint8_t period_bits[BRANCH_MAX_PERIOD];
+    uint32_t seed = 0x2545F491;
+    char label[32];
+    double taken_ns, taken_miss, random_ns, random_miss, ns, miss;
+    int largest_predicted = 0, predicted = 1;
+    if (!pattern) return;
+
+    fprintf(log_fp, "\nConditional branches (%d per pass):\n", BRANCH_PATTERN_LEN);
+    fprintf(log_fp, "%-16s %10s %12s\n", "Pattern", "ns/branch", "Mispred/br");
+
+    memset(pattern, 1, BRANCH_PATTERN_LEN);
+    taken_ns = measure_branch_pattern(c, pattern, &taken_miss);
+    log_branch_row(log_fp, "always taken", taken_ns, taken_miss);
+
+    for (int i = 0; i < BRANCH_PATTERN_LEN; i++) pattern[i] = xorshift32(&seed) & 1;
+    random_ns = measure_branch_pattern(c, pattern, &random_miss);
+
+    for (int period = 2; period <= BRANCH_MAX_PERIOD; period *= 2) {
+        for (int i = 0; i < period; i++) period_bits[i] = xorshift32(&seed) & 1;
+        for (int i = 0; i < BRANCH_PATTERN_LEN; i++) pattern[i] = period_bits[i % period];
+        ns = measure_branch_pattern(c, pattern, &miss);
+        snprintf(label, sizeof(label), "period %d", period);
+        log_branch_row(log_fp, label, ns, miss);
+        // "Predicted" while within 10% of the gap between always-taken and random.
+        predicted = predicted && ns < taken_ns + 0.1 * (random_ns - taken_ns);
+        if (predicted) largest_predicted = period;
+    }
+    log_branch_row(log_fp, "random", random_ns, random_miss);
+
+    // Without a counter assume a random branch is mispredicted half the time.
+    double rate = random_miss >= 0 && taken_miss >= 0 ? random_miss - taken_miss : 0.5;
+    if (rate > 0) {
+        double penalty_ns = (random_ns - taken_ns) / rate;
+        fprintf(log_fp, "Mispredict penalty: %.2f ns", penalty_ns);
+        if (g_cycle_ns > 0) fprintf(log_fp, " (~%.1f cycles)", penalty_ns / g_cycle_ns);
+        fprintf(log_fp, "%s\n", random_miss >= 0 ? "" : ", assuming 50% mispredicted random branches");
+        printf("Mispredict penalty: %.2f ns\n", penalty_ns);
+    }
+    if (largest_predicted > 0)
+        fprintf(log_fp, "Longest period predicted: %d branches\n", largest_predicted);
+    else
+        fprintf(log_fp, "Longest period predicted: none\n");
+    free(pattern);
+}
+
+static void run_indirect_fanout(FILE *log_fp, fe_counters_t *c) {
+    uint8_t cyclic[INDIRECT_SEQ_LEN], random_seq[INDIRECT_SEQ_LEN];
+    uint32_t seed = 0x9E3779B9;
+
+    fprintf(log_fp, "\nIndirect calls (%d per pass):\n", INDIRECT_SEQ_LEN);
+    fprintf(log_fp, "%8s %12s %12s %12s %12s\n", "Targets", "cyc ns/call", "cyc mis/call", "rnd ns/call", "rnd mis/call");
+
+    for (int targets = 1; targets <= INDIRECT_MAX_TARGETS; targets *= 2) {
+        for (int i = 0; i < INDIRECT_SEQ_LEN; i++) {
+            cyclic[i] = i % targets;
+            random_seq[i] = xorshift32(&seed) % targets;
+        }
+        fprintf(log_fp, "%8d", targets);
+        const uint8_t *seqs[2] = {cyclic, random_seq};
+        double ns[2];
+        for (int s = 0; s < 2; s++) {
+            indirect_ctx_t ctx = {seqs[s], 0};
+            bench_stats_t st;
+            bench_measure(indirect_body, &ctx, 16, FE_SAMPLES, &st);
+            fe_count(c, indirect_body, &ctx, 16);
+            ns[s] = st.median / INDIRECT_SEQ_LEN;
+            fprintf(log_fp, " %12.3f", ns[s]);
+            fe_log_col(log_fp, fe_have(c, EV_BRANCH_MISSES), c->count[EV_BRANCH_MISSES] / (16.0 * INDIRECT_SEQ_LEN));
+        }
+        fprintf(log_fp, "\n");
+        printf("indirect %2d targets: %7.3f / %7.3f ns/call (cyclic/random)\n", targets, ns[0], ns[1]);
+    }
+}
+
+/**
+ * @brief Frontend benchmark: generated code of growing footprint (I-cache,
+ *        iTLB), conditional branch patterns and indirect-call fan-out.
+ * @details Generated code needs A64 or x86-64 and a kernel that allows
+ *          mprotect(PROT_EXEC) on anonymous memory; the branch and indirect
+ *          tests are plain C. CPI and miss rates come from the PMU; without
+ *          it CPI is estimated against a dependent add chain (1 cycle/add).
+ */
+void run_frontend_benchmark(FILE *log_fp) {
+    fe_counters_t c;
+
+    fprintf(log_fp, "\n[Part G: Frontend (I-cache, iTLB, Branch Prediction)]\n");
+    printf("\nRunning Frontend Benchmark...\n");
+
+    fe_counters_open(&c);
+    g_cycle_ns = 0;
+
+#if JIT_SUPPORTED
+    jit_code_t j;
+    if (jit_build_linear(&j, 4096, 1) == 0) {
+        jit_ctx_t ctx = {(jit_fn_t)(void *)j.mem, 0};
+        bench_stats_t st;
+        // Best of a few rounds so the clock has ramped up under DVFS.
+        for (int round = 0; round < 4; round++) {
+            bench_measure(jit_body, &ctx, FE_INSNS_PER_SAMPLE / j.insns, FE_SAMPLES, &st);
+            double ns = st.median / (j.insns - 1);
+            if (g_cycle_ns == 0 || ns < g_cycle_ns) g_cycle_ns = ns;
+        }
+        jit_free(&j);
+    }
+#endif
+
+    if (fe_have(&c, EV_CYCLES) && fe_have(&c, EV_INSNS))
+        fprintf(log_fp, "CPI from PMU cycle/instruction counters\n");
+    else if (g_cycle_ns > 0)
+        fprintf(log_fp, "PMU unavailable; CPI estimated from a dependent add chain (%.3f ns/cycle, ~%.2f GHz)\n",
+                g_cycle_ns, 1.0 / g_cycle_ns);
+    else
+        fprintf(log_fp, "PMU unavailable; CPI not reported\n");
+
+#if JIT_SUPPORTED
+    run_code_footprint(log_fp, &c);
+    run_code_pages(log_fp, &c);
+#else
+    fprintf(log_fp, "Code generation not supported on this architecture; footprint tests skipped\n");
+#endif
+    run_branch_patterns(log_fp, &c);
+    run_indirect_fanout(log_fp, &c);
+
+    fe_counters_close(&c);
+}
@@ -0,0 +1,13 @@
+#ifndef FRONTEND_BENCH_H
+#define FRONTEND_BENCH_H
+
+#include <stdio.h>
+
+/**
+ * @brief Frontend benchmark: generated code of growing footprint (I-cache,
+ *        iTLB), conditional branch patterns and indirect-call fan-out.
+ * @param log_fp Pointer to the hardware_info.txt file.
+ */
+void run_frontend_benchmark(FILE *log_fp);
+
+#endif
@@ -7,16 +7,22 @@
 #include <dirent.h>
 #include <pthread.h>
 
+#include "bench_stats.h"
+#include "os_bench.h"
+#include "alloc_bench.h"
+#include "monitor.h"
+#include "kernels.h"
+#include "fill_bench.h"
+#include "load_gen.h"
+#include "frontend_bench.h"
+#include "freq_sweep.h"
+#include "ipc_bench.h"
+
 
 #define L1_SIZE_TEST (16 * 1024)         // 16KB
 #define L2_SIZE_TEST (512 * 1024)        // 512KB
 #define MEM_SIZE_TEST (64 * 1024 * 1024) // 64MB
 
-typedef struct {
-    int duration;
-    size_t buffer_size;
-} thread_args_t;
-
 /**
  * @brief Reads a single line from a system file (sysfs) and logs it. [cite: 162]
  * @param path The absolute path to the system file.
@@ -36,31 +42,6 @@ void log_sys_value(const char *path, const char *label, FILE *log_fp) {
     }
 }
 
-/**
- * @brief Thread function that generates mixed CPU/Memory load.
- */
-void* stress_worker(void* args) {
-    thread_args_t* t_args = (thread_args_t*)args;
-    size_t size = t_args->buffer_size;
-    uint32_t *src = malloc(size);
-    uint32_t *dst = malloc(size);
-
-    if (!src || !dst) return NULL;
-
-    time_t start = time(NULL);
-    volatile float dummy = 1.414f;
-
-    while (time(NULL) - start < t_args->duration) {
-        for (int i = 0; i < (int)(size / 4); i++) {
-            dst[i] = src[i];
-            dummy = (dummy / 1.000001f) + 0.00001f;
-        }
-    }
-
-    free(src); free(dst);
-    return NULL;
-}
-
 /**
  * @brief Reads the desired benchmark duration from a configuration file.
  * @details Looks for "benchmark_time=" in config.txt. Defaults to 60s if not found.
@@ -83,6 +64,27 @@ int read_config_int(const char *key, int default_val) {
     return val;
 }
 
+/**
+ * @brief Reads a string value from the configuration file.
+ * @details Looks for "<key>=" in config.txt; copies @p default_val if not found.
+ */
+void read_config_str(const char *key, char *out, size_t size, const char *default_val) {
+    snprintf(out, size, "%s", default_val);
+    FILE *cf = fopen("config.txt", "r");
+    if (cf) {
+        char line[256];
+        size_t key_len = strlen(key);
+        while (fgets(line, sizeof(line), cf)) {
+            if (strncmp(line, key, key_len) == 0 && line[key_len] == '=') {
+                line[strcspn(line, "\r\n")] = 0;
+                snprintf(out, size, "%s", line + key_len + 1);
+                break;
+            }
+        }
+        fclose(cf);
+    }
+}
+
 /**
  * @brief Fetches specific hardware data using the vcgencmd utility.
  * @param cmd_type The specific vcgencmd command (e.g., "measure_temp").
@@ -159,6 +161,9 @@ void scan_usb_devices(FILE *log_fp) {
 
 /**
  * @brief Helper function to measure memory bandwidth.
+ * @details Copies through kernel_run(), so the figure reflects the copy
+ *          variant the kernel library selected for this board. One untimed
+ *          copy picks the variant before the clock starts.
  */
 double measure_bandwidth(size_t size, int iterations) {
     uint8_t *src = (uint8_t *)malloc(size);
@@ -167,12 +172,13 @@ double measure_bandwidth(size_t size, int iterations) {
 
     memset(src, 0xAA, size);
     memset(dst, 0xBB, size);
+    kernel_run(KERNEL_COPY, dst, src, NULL, size);
 
     struct timespec start, end;
     clock_gettime(CLOCK_MONOTONIC, &start);
 
     for (int i = 0; i < iterations; i++) {
-        memcpy(dst, src, size);
+        kernel_run(KERNEL_COPY, dst, src, NULL, size);
         __asm__ volatile("" : : "r"(dst) : "memory");
     }
 
@@ -234,6 +240,14 @@ void generate_info_report() {
     probe_cache_info(fp);
     scan_usb_devices(fp);
     run_memory_hierarchy_benchmark(fp);
+    if (read_config_int("os_benchmark", 1)) run_os_overhead_benchmark(fp);
+    if (read_config_int("alloc_benchmark", 1))
+        run_allocator_benchmark(fp, read_config_int("thread", 1));
+    run_kernel_library_report(fp, read_config_int("kernel_tune", 0));
+    if (read_config_int("fill_benchmark", 1)) run_fill_benchmark(fp);
+    if (read_config_int("frontend_benchmark", 1)) run_frontend_benchmark(fp);
+    if (read_config_int("freq_sweep", 0)) run_freq_sweep(fp);
+    if (read_config_int("ipc_benchmark", 1)) run_ipc_benchmark(fp);
 
     fclose(fp);
     printf("\n[Success] Static info saved to hardware_info.txt\n");
@@ -241,24 +255,48 @@ void generate_info_report() {
 
 /**
  * @brief Runs a stress test and logs thermal/clock data to a file. [cite: 158]
- * @details Performs high-intensity memory copies and logs data every second. [cite: 160]
+ * @details Drives the load generator with the profile from config.txt
+ *          (load_profile, load_mix, load_duty, ...) and logs data every
+ *          second. [cite: 160] Per-thread work rates go to load_report.txt.
  * @param duration_sec How long the stress test should run.
  * @note Answers Assignment Questions 27 and 28. [cite: 159]
  */
 void run_stress_benchmark(int duration_sec, int num_threads) {
+    load_config_t cfg;
+    char profile[32], mix[128], steps[128];
+    read_config_str("load_profile", profile, sizeof(profile), "constant");
+    read_config_str("load_mix", mix, sizeof(mix), "legacy");
+    read_config_str("load_steps", steps, sizeof(steps), "25,50,75,100");
+    if (load_config_parse(&cfg, profile, mix, steps) != 0) {
+        printf("[Error] Unknown load_profile '%s' or load_mix '%s'\n", profile, mix);
+        return;
+    }
+    if (strcmp(profile, "power_virus") != 0) cfg.duty_pct = read_config_int("load_duty", 100);
+    cfg.ramp_start_pct = read_config_int("load_ramp_start", 10);
+    cfg.ramp_end_pct = read_config_int("load_ramp_end", 100);
+    cfg.step_sec = read_config_int("load_step_sec", duration_sec / (cfg.num_steps > 0 ? cfg.num_steps : 1));
+    cfg.period_ms = read_config_int("load_period_ms", 100);
+    cfg.duration_sec = duration_sec;
+
     FILE *fp = fopen("hardware_benchmark.txt", "w");
     if (!fp) return;
 
     fprintf(fp, "Stress Test (Duration: %ds, Threads: %d)\n", duration_sec, num_threads);
     fprintf(fp, "Time(s),Temp(C),CPU_Freq(MHz),Volts(V)\n");
 
-    printf("Starting stress test with %d threads for %d seconds...\n", num_threads, duration_sec);
+    printf("Starting stress test with %d threads for %d seconds (profile %s, mix %s)...\n",
+           num_threads, duration_sec, profile, strcmp(profile, "power_virus") ? mix : "virus");
 
     pthread_t threads[num_threads];
-    thread_args_t t_args = {duration_sec, 10 * 1024 * 1024};
+    load_thread_t t_args[num_threads];
+    double start_ns = bench_now_ns();
 
     for (int i = 0; i < num_threads; i++) {
-        pthread_create(&threads[i], NULL, stress_worker, &t_args);
+        memset(&t_args[i], 0, sizeof(t_args[i]));
+        t_args[i].cfg = &cfg;
+        t_args[i].id = i;
+        t_args[i].start_ns = start_ns;
+        pthread_create(&threads[i], NULL, load_worker, &t_args[i]);
     }
 
     time_t start = time(NULL);
@@ -280,6 +318,15 @@ void run_stress_benchmark(int duration_sec, int num_threads) {
 
     for (int i = 0; i < num_threads; i++) pthread_join(threads[i], NULL);
     fclose(fp);
+
+    load_report(stdout, t_args, num_threads);
+    FILE *rp = fopen("load_report.txt", "w");
+    if (rp) {
+        fprintf(rp, "Load profile %s, mix %s, %d threads, %ds\n", profile,
+                strcmp(profile, "power_virus") ? mix : "virus", num_threads, duration_sec);
+        load_report(rp, t_args, num_threads);
+        fclose(rp);
+    }
 }
 
 /**
@@ -293,6 +340,15 @@ int main() {
 
     printf("Configuration: Time=%ds, Threads=%d\n", b_time, num_threads);
 
+    if (read_config_int("daemon", 0)) {
+        monitor_config_t mon;
+        mon.port = read_config_int("monitor_port", 9101);
+        mon.interval_ms = read_config_int("monitor_interval_ms", 1000);
+        mon.probe_interval_sec = read_config_int("monitor_probe_sec", 10);
+        read_config_str("monitor_socket", mon.socket_path, sizeof(mon.socket_path), "");
+        return run_monitor_daemon(&mon);
+    }
+
     generate_info_report();
     run_stress_benchmark(b_time, num_threads);
 
@@ -0,0 +1,597 @@
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sched.h>
+#include <signal.h>
+#include <errno.h>
+#include <sys/mman.h>
+#include <sys/resource.h>
+#include <sys/sendfile.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <sys/wait.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+
+#include "bench_stats.h"
+#include "ipc_bench.h"
+
+#define IPC_MAX_PAYLOAD (16 * 1024 * 1024)
+#define IPC_RING_BYTES (4 * 1024 * 1024)
+#define IPC_PIPE_BYTES (1024 * 1024)   // F_SETPIPE_SZ, the unprivileged maximum by default
+#define IPC_LAT_BYTES (64L * 1024 * 1024)
+#define IPC_TPUT_BYTES (128L * 1024 * 1024)
+#define IPC_MIN_MSGS 8
+#define IPC_MAX_LAT_MSGS 2000
+#define IPC_MAX_TPUT_MSGS 100000
+#define IPC_UDP_DGRAM 60000
+#define IPC_UDP_WINDOW (2 * IPC_UDP_DGRAM) // bytes in flight before the sender waits for a credit
+#define IPC_TIMEOUT_SEC 2
+#define IPC_SPINS 256                      // busy-wait rounds before sched_yield()
+
+static const size_t ipc_payloads[] = {64, 1024, 64 * 1024, 1024 * 1024, IPC_MAX_PAYLOAD};
+#define PAYLOAD_COUNT ((int)(sizeof(ipc_payloads) / sizeof(ipc_payloads[0])))
+
+/**
+ * @brief Single-producer/single-consumer byte ring in POSIX shared memory.
+ *        head and tail are free-running byte counts on separate lines.
+ */
+typedef struct {
+    uint64_t head;
+    char pad0[56];
+    uint64_t tail;
+    char pad1[56];
+    uint8_t data[IPC_RING_BYTES];
+} shm_ring_t;
+
+/**
+ * @brief Both ends of one transport. The sender owns tx/ack_rx, the
+ *        receiver rx/ack_tx; for sockets the pairs are the same fd.
+ */
+typedef struct {
+    int tx, rx;
+    int ack_tx, ack_rx;
+    int src_fd;          // sendfile source
+    shm_ring_t *ring;    // data, sender -> receiver
+    shm_ring_t *ack_ring;
+    pid_t peer;
+    int is_receiver;
+    int peer_reaped;
+    size_t udp_window;   // UDP bytes since the last credit, across messages
+} ipc_chan_t;
+
+typedef struct {
+    const char *name;
+    int (*setup)(ipc_chan_t *c);
+    int (*send)(ipc_chan_t *c, const uint8_t *buf, size_t len);
+    int (*recv)(ipc_chan_t *c, uint8_t *buf, size_t len);
+    int (*ack)(ipc_chan_t *c);
+    int (*wait_ack)(ipc_chan_t *c);
+} ipc_transport_t;
+
+/**
+ * @brief What the receiver reports back after each throughput run.
+ */
+typedef struct {
+    double cpu_sec;
+    int ok;
+} ipc_result_t;
+
+static double cpu_seconds(void) {
+    struct rusage ru;
+    getrusage(RUSAGE_SELF, &ru);
+    return ru.ru_utime.tv_sec + ru.ru_stime.tv_sec + (ru.ru_utime.tv_usec + ru.ru_stime.tv_usec) / 1e6;
+}
+
+static int pin_process(int cpu) {
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    return sched_setaffinity(0, sizeof(set), &set);
+}
+
+static void close_fd(int *fd) {
+    if (*fd >= 0) close(*fd);
+    *fd = -1;
+}
+
+/* ---- fd transports ---- */
+
+static int write_all(int fd, const uint8_t *buf, size_t len) {
+    while (len > 0) {
+        ssize_t n = write(fd, buf, len);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return -1;
+        buf += n;
+        len -= n;
+    }
+    return 0;
+}
+
+static int read_all(int fd, uint8_t *buf, size_t len) {
+    while (len > 0) {
+        ssize_t n = read(fd, buf, len);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return -1;
+        buf += n;
+        len -= n;
+    }
+    return 0;
+}
+
+static int fd_send(ipc_chan_t *c, const uint8_t *buf, size_t len) { return write_all(c->tx, buf, len); }
+static int fd_recv(ipc_chan_t *c, uint8_t *buf, size_t len) { return read_all(c->rx, buf, len); }
+
+static int fd_ack(ipc_chan_t *c) {
+    uint8_t b = 1;
+    return write_all(c->ack_tx, &b, 1);
+}
+
+static int fd_wait_ack(ipc_chan_t *c) {
+    uint8_t b;
+    return read_all(c->ack_rx, &b, 1);
+}
+
+static int pipe_setup(ipc_chan_t *c) {
+    int data[2], ack[2];
+    if (pipe(data) != 0) return -1;
+    if (pipe(ack) != 0) {
+        close(data[0]);
+        close(data[1]);
+        return -1;
+    }
+    fcntl(data[1], F_SETPIPE_SZ, IPC_PIPE_BYTES);
+    c->rx = data[0];
+    c->tx = data[1];
+    c->ack_rx = ack[0];
+    c->ack_tx = ack[1];
+    return 0;
+}
+
+/**
+ * @brief Maps the payload pages into the pipe instead of copying them. The
+ *        buffer is never modified while in flight, so no gifting is needed.
+ */
+static int vmsplice_send(ipc_chan_t *c, const uint8_t *buf, size_t len) {
+    while (len > 0) {
+        struct iovec iov = {(void *)buf, len};
+        ssize_t n = vmsplice(c->tx, &iov, 1, 0);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return -1;
+        buf += n;
+        len -= n;
+    }
+    return 0;
+}
+
+static int socketpair_setup(ipc_chan_t *c) {
+    int sv[2];
+    if (socketpair(AF_UNIX, SOCK_STREAM, 0, sv) != 0) return -1;
+    c->tx = c->ack_rx = sv[0];
+    c->rx = c->ack_tx = sv[1];
+    return 0;
+}
+
+/**
+ * @brief Unix socket pair plus a memfd holding the largest payload, so
+ *        sendfile() can move page-cache pages straight into the socket.
+ */
+static int sendfile_setup(ipc_chan_t *c) {
+    static uint8_t chunk[64 * 1024];
+    if (socketpair_setup(c) != 0) return -1;
+    c->src_fd = memfd_create("ipc_bench_src", 0);
+    if (c->src_fd < 0) return -1;
+    memset(chunk, 0x5A, sizeof(chunk));
+    for (size_t off = 0; off < IPC_MAX_PAYLOAD; off += sizeof(chunk))
+        if (write_all(c->src_fd, chunk, sizeof(chunk)) != 0) return -1;
+    return 0;
+}
+
+static int sendfile_send(ipc_chan_t *c, const uint8_t *buf, size_t len) {
+    off_t off = 0;
+    (void)buf;
+    while ((size_t)off < len) {
+        ssize_t n = sendfile(c->tx, c->src_fd, &off, len - off);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return -1;
+    }
+    return 0;
+}
+
+static int tcp_setup(ipc_chan_t *c) {
+    struct sockaddr_in addr;
+    socklen_t alen = sizeof(addr);
+    int one = 1;
+    int lfd = socket(AF_INET, SOCK_STREAM, 0);
+    if (lfd < 0) return -1;
+
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    if (bind(lfd, (struct sockaddr *)&addr, sizeof(addr)) != 0 || listen(lfd, 1) != 0 ||
+        getsockname(lfd, (struct sockaddr *)&addr, &alen) != 0) {
+        close(lfd);
+        return -1;
+    }
+    c->tx = socket(AF_INET, SOCK_STREAM, 0);
+    if (c->tx < 0 || connect(c->tx, (struct sockaddr *)&addr, sizeof(addr)) != 0) {
+        close(lfd);
+        return -1;
+    }
+    c->rx = accept(lfd, NULL, NULL);
+    close(lfd);
+    if (c->rx < 0) return -1;
+    setsockopt(c->tx, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+    setsockopt(c->rx, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+    c->ack_rx = c->tx;
+    c->ack_tx = c->rx;
+    return 0;
+}
+
+/**
+ * @brief Two connected loopback UDP sockets. UDP has no flow control, so
+ *        the receiver returns a one-byte credit for every IPC_UDP_WINDOW
+ *        bytes of the stream, counted across message boundaries by both
+ *        sides; a lost datagram ends the run through SO_RCVTIMEO.
+ */
+static int udp_setup(ipc_chan_t *c) {
+    struct sockaddr_in addr[2];
+    socklen_t alen = sizeof(addr[0]);
+    struct timeval tv = {IPC_TIMEOUT_SEC, 0};
+    int rcvbuf = 4 * 1024 * 1024;
+    int fd[2];
+
+    for (int i = 0; i < 2; i++) {
+        fd[i] = socket(AF_INET, SOCK_DGRAM, 0);
+        // Stored right away so chan_teardown() closes them on failure.
+        if (i == 0)
+            c->tx = c->ack_rx = fd[0];
+        else
+            c->rx = c->ack_tx = fd[1];
+        if (fd[i] < 0) return -1;
+        memset(&addr[i], 0, sizeof(addr[i]));
+        addr[i].sin_family = AF_INET;
+        addr[i].sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        if (bind(fd[i], (struct sockaddr *)&addr[i], sizeof(addr[i])) != 0 ||
+            getsockname(fd[i], (struct sockaddr *)&addr[i], &alen) != 0)
+            return -1;
+        setsockopt(fd[i], SOL_SOCKET, SO_RCVBUF, &rcvbuf, sizeof(rcvbuf));
+        setsockopt(fd[i], SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+    }
+    if (connect(fd[0], (struct sockaddr *)&addr[1], sizeof(addr[1])) != 0 ||
+        connect(fd[1], (struct sockaddr *)&addr[0], sizeof(addr[0])) != 0)
+        return -1;
+    return 0;
+}
+
+static int udp_send(ipc_chan_t *c, const uint8_t *buf, size_t len) {
+    size_t done = 0;
+    uint8_t credit;
+    while (done < len) {
+        size_t n = len - done < IPC_UDP_DGRAM ? len - done : IPC_UDP_DGRAM;
+        if (send(c->tx, buf + done, n, 0) != (ssize_t)n) return -1;
+        done += n;
+        c->udp_window += n;
+        if (c->udp_window >= IPC_UDP_WINDOW) {
+            if (recv(c->tx, &credit, 1, 0) != 1) return -1;
+            c->udp_window = 0;
+        }
+    }
+    return 0;
+}
+
+static int udp_recv(ipc_chan_t *c, uint8_t *buf, size_t len) {
+    size_t done = 0;
+    uint8_t credit = 1;
+    while (done < len) {
+        size_t n = len - done < IPC_UDP_DGRAM ? len - done : IPC_UDP_DGRAM;
+        if (recv(c->rx, buf + done, n, 0) != (ssize_t)n) return -1;
+        done += n;
+        c->udp_window += n;
+        if (c->udp_window >= IPC_UDP_WINDOW) {
+            if (send(c->rx, &credit, 1, 0) != 1) return -1;
+            c->udp_window = 0;
+        }
+    }
+    return 0;
+}
+
+static int udp_ack(ipc_chan_t *c) {
+    uint8_t b = 1;
+    return send(c->ack_tx, &b, 1, 0) == 1 ? 0 : -1;
+}
+
+static int udp_wait_ack(ipc_chan_t *c) {
+    uint8_t b;
+    return recv(c->ack_rx, &b, 1, 0) == 1 ? 0 : -1;
+}
+
+/* ---- shared-memory ring ---- */
+
+static int peer_gone(ipc_chan_t *c) {
+    int status;
+    if (c->is_receiver) return getppid() != c->peer;
+    if (!c->peer_reaped && waitpid(c->peer, &status, WNOHANG) == c->peer) c->peer_reaped = 1;
+    return c->peer_reaped;
+}
+
+/**
+ * @brief Spins, then yields; returns -1 once the other process has died.
+ */
+static int ring_wait(ipc_chan_t *c, unsigned *spins) {
+    if (++*spins < IPC_SPINS) return 0;
+    sched_yield();
+    if ((*spins & 4095) == 0 && peer_gone(c)) return -1;
+    return 0;
+}
+
+static int ring_write(ipc_chan_t *c, shm_ring_t *r, const uint8_t *buf, size_t len) {
+    uint64_t head = r->head;
+    unsigned spins = 0;
+    while (len > 0) {
+        size_t space = IPC_RING_BYTES - (head - __atomic_load_n(&r->tail, __ATOMIC_ACQUIRE));
+        if (space == 0) {
+            if (ring_wait(c, &spins) != 0) return -1;
+            continue;
+        }
+        size_t off = head % IPC_RING_BYTES;
+        size_t n = len < space ? len : space;
+        if (n > IPC_RING_BYTES - off) n = IPC_RING_BYTES - off;
+        memcpy(r->data + off, buf, n);
+        head += n;
+        buf += n;
+        len -= n;
+        __atomic_store_n(&r->head, head, __ATOMIC_RELEASE);
+        spins = 0;
+    }
+    return 0;
+}
+
+static int ring_read(ipc_chan_t *c, shm_ring_t *r, uint8_t *buf, size_t len) {
+    uint64_t tail = r->tail;
+    unsigned spins = 0;
+    while (len > 0) {
+        size_t avail = __atomic_load_n(&r->head, __ATOMIC_ACQUIRE) - tail;
+        if (avail == 0) {
+            if (ring_wait(c, &spins) != 0) return -1;
+            continue;
+        }
+        size_t off = tail % IPC_RING_BYTES;
+        size_t n = len < avail ? len : avail;
+        if (n > IPC_RING_BYTES - off) n = IPC_RING_BYTES - off;
+        memcpy(buf, r->data + off, n);
+        tail += n;
+        buf += n;
+        len -= n;
+        __atomic_store_n(&r->tail, tail, __ATOMIC_RELEASE);
+        spins = 0;
+    }
+    return 0;
+}
+
+static int shm_setup(ipc_chan_t *c) {
+    char name[64];
+    snprintf(name, sizeof(name), "/hwbench_ipc_%d", (int)getpid());
+    int fd = shm_open(name, O_RDWR | O_CREAT | O_EXCL, 0600);
+    if (fd < 0) return -1;
+    shm_unlink(name); // the mapping outlives the name; nothing is left behind on a crash
+    if (ftruncate(fd, 2 * sizeof(shm_ring_t)) != 0) {
+        close(fd);
+        return -1;
+    }
+    void *p = mmap(NULL, 2 * sizeof(shm_ring_t), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (p == MAP_FAILED) return -1;
+    c->ring = (shm_ring_t *)p;
+    c->ack_ring = c->ring + 1;
+    return 0;
+}
+
+static int shm_send(ipc_chan_t *c, const uint8_t *buf, size_t len) { return ring_write(c, c->ring, buf, len); }
+static int shm_recv(ipc_chan_t *c, uint8_t *buf, size_t len) { return ring_read(c, c->ring, buf, len); }
+
+static int shm_ack(ipc_chan_t *c) {
+    uint8_t b = 1;
+    return ring_write(c, c->ack_ring, &b, 1);
+}
+
+static int shm_wait_ack(ipc_chan_t *c) {
+    uint8_t b;
+    return ring_read(c, c->ack_ring, &b, 1);
+}
+
+static const ipc_transport_t transports[] = {
+    {"shm ring", shm_setup, shm_send, shm_recv, shm_ack, shm_wait_ack},
+    {"pipe", pipe_setup, fd_send, fd_recv, fd_ack, fd_wait_ack},
+    {"vmsplice", pipe_setup, vmsplice_send, fd_recv, fd_ack, fd_wait_ack},
+    {"sendfile", sendfile_setup, sendfile_send, fd_recv, fd_ack, fd_wait_ack},
+    {"unix stream", socketpair_setup, fd_send, fd_recv, fd_ack, fd_wait_ack},
+    {"tcp loopback", tcp_setup, fd_send, fd_recv, fd_ack, fd_wait_ack},
+    {"udp loopback", udp_setup, udp_send, udp_recv, udp_ack, udp_wait_ack},
+};
+#define TRANSPORT_COUNT ((int)(sizeof(transports) / sizeof(transports[0])))
+
+static long message_count(long total_bytes, size_t payload, long max_msgs) {
+    long n = total_bytes / (long)payload;
+    if (n < IPC_MIN_MSGS) n = IPC_MIN_MSGS;
+    if (n > max_msgs) n = max_msgs;
+    return n;
+}
+
+static void chan_teardown(ipc_chan_t *c) {
+    if (c->ack_rx == c->tx) c->ack_rx = -1;
+    if (c->ack_tx == c->rx) c->ack_tx = -1;
+    close_fd(&c->tx);
+    close_fd(&c->rx);
+    close_fd(&c->ack_tx);
+    close_fd(&c->ack_rx);
+    close_fd(&c->src_fd);
+    if (c->ring) munmap(c->ring, 2 * sizeof(shm_ring_t));
+    c->ring = c->ack_ring = NULL;
+}
+
+/**
+ * @brief Receiver process: mirrors the sender's message sequence, checks
+ *        the first message of each size and reports its CPU time.
+ */
+static void ipc_receiver(const ipc_transport_t *t, ipc_chan_t *c, const uint8_t *expect, int result_fd) {
+    uint8_t *buf = malloc(IPC_MAX_PAYLOAD);
+    if (!buf) return;
+    memset(buf, 0, IPC_MAX_PAYLOAD);
+
+    for (int p = 0; p < PAYLOAD_COUNT; p++) {
+        size_t size = ipc_payloads[p];
+        ipc_result_t res = {0, 1};
+        long lat_msgs = message_count(IPC_LAT_BYTES, size, IPC_MAX_LAT_MSGS);
+        long tput_msgs = message_count(IPC_TPUT_BYTES, size, IPC_MAX_TPUT_MSGS);
+
+        for (long i = 0; i < lat_msgs; i++) {
+            if (t->recv(c, buf, size) != 0) return;
+            if (i == 0 && memcmp(buf, expect, size) != 0) res.ok = 0;
+            if (t->ack(c) != 0) return;
+        }
+        double cpu0 = cpu_seconds();
+        for (long i = 0; i < tput_msgs; i++)
+            if (t->recv(c, buf, size) != 0) return;
+        res.cpu_sec = cpu_seconds() - cpu0;
+        if (t->ack(c) != 0) return;
+        if (write_all(result_fd, (const uint8_t *)&res, sizeof(res)) != 0) return;
+    }
+    free(buf);
+}
+
+static void format_size(char *buf, size_t size, size_t bytes) {
+    if (bytes >= 1024 * 1024)
+        snprintf(buf, size, "%zuMB", bytes / (1024 * 1024));
+    else if (bytes >= 1024)
+        snprintf(buf, size, "%zuKB", bytes / 1024);
+    else
+        snprintf(buf, size, "%zuB", bytes);
+}
+
+/**
+ * @brief Sender side of one transport; logs one row per payload size.
+ */
+static void run_transport(FILE *log_fp, const ipc_transport_t *t, uint8_t *payload, int send_cpu, int recv_cpu) {
+    ipc_chan_t c = {-1, -1, -1, -1, -1, NULL, NULL, 0, 0, 0, 0};
+    int result[2];
+    char label[24];
+
+    if (t->setup(&c) != 0) {
+        fprintf(log_fp, "%-13s setup failed\n", t->name);
+        chan_teardown(&c);
+        return;
+    }
+    if (pipe(result) != 0) {
+        chan_teardown(&c);
+        return;
+    }
+
+    pid_t parent = getpid();
+    pid_t pid = fork();
+    if (pid < 0) {
+        close(result[0]);
+        close(result[1]);
+        chan_teardown(&c);
+        return;
+    }
+    if (pid == 0) {
+        close(result[0]);
+        if (c.ack_rx != c.tx) close_fd(&c.ack_rx);
+        close_fd(&c.tx);
+        c.ack_rx = -1;
+        c.is_receiver = 1;
+        c.peer = parent;
+        pin_process(recv_cpu);
+        ipc_receiver(t, &c, payload, result[1]);
+        _exit(0);
+    }
+
+    close(result[1]);
+    if (c.ack_tx != c.rx) close_fd(&c.ack_tx);
+    close_fd(&c.rx);
+    c.ack_tx = -1;
+    c.peer = pid;
+    pin_process(send_cpu);
+
+    double *samples = malloc(IPC_MAX_LAT_MSGS * sizeof(double));
+    int failed = samples == NULL;
+    for (int p = 0; p < PAYLOAD_COUNT && !failed; p++) {
+        size_t size = ipc_payloads[p];
+        long lat_msgs = message_count(IPC_LAT_BYTES, size, IPC_MAX_LAT_MSGS);
+        long tput_msgs = message_count(IPC_TPUT_BYTES, size, IPC_MAX_TPUT_MSGS);
+        bench_stats_t lat;
+        ipc_result_t res;
+
+        // Latency: one message, then wait for the receiver's one-byte ack.
+        for (long i = 0; i < lat_msgs && !failed; i++) {
+            double t0 = bench_now_ns();
+            failed = t->send(&c, payload, size) != 0 || t->wait_ack(&c) != 0;
+            samples[i] = (bench_now_ns() - t0) / 1000.0;
+        }
+        if (failed) break;
+        bench_stats_compute(samples, (int)lat_msgs, &lat);
+
+        // Throughput: back-to-back messages, one ack at the end.
+        double cpu0 = cpu_seconds();
+        double t0 = bench_now_ns();
+        for (long i = 0; i < tput_msgs && !failed; i++) failed = t->send(&c, payload, size) != 0;
+        failed = failed || t->wait_ack(&c) != 0;
+        double elapsed_ns = bench_now_ns() - t0;
+        double cpu = cpu_seconds() - cpu0;
+        failed = failed || read_all(result[0], (uint8_t *)&res, sizeof(res)) != 0;
+        if (failed) break;
+
+        double bytes = (double)size * tput_msgs;
+        format_size(label, sizeof(label), size);
+        fprintf(log_fp, "%-13s %8s %10.1f %10.2f %10.2f %10.3f%s\n", t->name, label,
+                bytes / (elapsed_ns / 1e9) / (1024.0 * 1024.0), lat.median, lat.p99,
+                (cpu + res.cpu_sec) / (bytes / 1e9), res.ok ? "" : "  CORRUPT");
+        printf("%-13s %6s: %9.1f MB/s, p50 %8.2f us\n", t->name, label,
+               bytes / (elapsed_ns / 1e9) / (1024.0 * 1024.0), lat.median);
+    }
+    if (failed) fprintf(log_fp, "%-13s failed (peer exited, timeout or lost datagram)\n", t->name);
+
+    free(samples);
+    close(result[0]);
+    if (failed && !c.peer_reaped) kill(pid, SIGKILL);
+    chan_teardown(&c);
+    if (!c.peer_reaped) waitpid(pid, NULL, 0);
+}
+
+/**
+ * @brief Inter-process transport benchmark: shared-memory ring, pipes,
+ *        vmsplice, sendfile, Unix sockets and TCP/UDP loopback between two
+ *        pinned processes.
+ * @details Latency is the round trip of one message plus a one-byte ack.
+ *          CPU s/GB is user+system time of both processes during the
+ *          throughput run divided by the data moved.
+ */
+void run_ipc_benchmark(FILE *log_fp) {
+    fprintf(log_fp, "\n[Part I: Inter-Process Transport]\n");
+    printf("\nRunning IPC Transport Benchmark...\n");
+
+    int cpus = (int)sysconf(_SC_NPROCESSORS_ONLN);
+    int send_cpu = 0, recv_cpu = cpus > 1 ? 1 : 0;
+    cpu_set_t old_mask;
+    sched_getaffinity(0, sizeof(old_mask), &old_mask);
+
+    uint8_t *payload = malloc(IPC_MAX_PAYLOAD);
+    if (!payload) return;
+    memset(payload, 0x5A, IPC_MAX_PAYLOAD); // matches the sendfile source
+    void (*old_sigpipe)(int) = signal(SIGPIPE, SIG_IGN);
+
+    fprintf(log_fp, "Sender on CPU%d, receiver on CPU%d%s\n", send_cpu, recv_cpu,
+            cpus > 1 ? "" : " (1 CPU online, processes share it)");
+    fprintf(log_fp, "%-13s %8s %10s %10s %10s %10s\n", "Transport", "Payload", "MB/s", "p50(us)", "p99(us)", "CPU s/GB");
+    for (int i = 0; i < TRANSPORT_COUNT; i++) run_transport(log_fp, &transports[i], payload, send_cpu, recv_cpu);
+
+    signal(SIGPIPE, old_sigpipe);
+    sched_setaffinity(0, sizeof(old_mask), &old_mask);
+    free(payload);
+}
@@ -0,0 +1,14 @@
+#ifndef IPC_BENCH_H
+#define IPC_BENCH_H
+
+#include <stdio.h>
+
+/**
+ * @brief Inter-process transport benchmark: shared-memory ring, pipes,
+ *        vmsplice, sendfile, Unix sockets and TCP/UDP loopback between two
+ *        pinned processes.
+ * @param log_fp Pointer to the hardware_info.txt file.
+ */
+void run_ipc_benchmark(FILE *log_fp);
+
+#endif
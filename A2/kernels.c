@@ -0,0 +1,448 @@
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#elif defined(__aarch64__) || defined(__arm__)
+#include <sys/auxv.h>
+#endif
+#if defined(__aarch64__) && !defined(HWCAP_ASIMD)
+#define HWCAP_ASIMD (1 << 1)
+#endif
+#if defined(__arm__) && !defined(HWCAP_ARM_NEON)
+#define HWCAP_ARM_NEON (1 << 12)
+#endif
+#if defined(__aarch64__)
+#include <arm_neon.h>
+#endif
+
+#include "bench_stats.h"
+#include "kernels.h"
+
+#define TUNE_SMALL_BYTES (256 * 1024)       // 256KB, L2-resident
+#define TUNE_LARGE_BYTES (16 * 1024 * 1024) // 16MB, DRAM
+#define TUNE_SAMPLES 5
+
+// ---- non-temporal stores, one per vector width ----
+
+#if defined(__x86_64__) || defined(__i386__)
+static inline void nt_store_s4(void *p, const void *v) { _mm_stream_si32((int *)p, *(const int *)v); }
+#if defined(__x86_64__)
+static inline void nt_store_s8(void *p, const void *v) { _mm_stream_si64((long long *)p, *(const long long *)v); }
+#else
+static inline void nt_store_s8(void *p, const void *v) { memcpy(p, v, 8); }
+#endif
+static inline void nt_store_v128(void *p, const void *v) {
+    _mm_stream_si128((__m128i *)p, _mm_loadu_si128((const __m128i *)v));
+}
+static inline __attribute__((target("avx"))) void nt_store_v256(void *p, const void *v) {
+    _mm256_stream_si256((__m256i *)p, _mm256_loadu_si256((const __m256i *)v));
+}
+#define NT_FENCE() _mm_sfence()
+#define KTARGET_v256 __attribute__((target("avx2")))
+#elif defined(__aarch64__)
+static inline void nt_store_s4(void *p, const void *v) { memcpy(p, v, 4); }
+static inline void nt_store_s8(void *p, const void *v) { memcpy(p, v, 8); }
+static inline void nt_store_v128(void *p, const void *v) {
+    uint64x2_t t = vld1q_u64((const uint64_t *)v);
+    __asm__ volatile("stnp %d1, %d2, [%0]" : : "r"(p), "w"(vget_low_u64(t)), "w"(vget_high_u64(t)) : "memory");
+}
+static inline void nt_store_v256(void *p, const void *v) {
+    uint8x16_t lo = vld1q_u8((const uint8_t *)v), hi = vld1q_u8((const uint8_t *)v + 16);
+    __asm__ volatile("stnp %q1, %q2, [%0]" : : "r"(p), "w"(lo), "w"(hi) : "memory");
+}
+#define NT_FENCE() do { } while (0)
+#define KTARGET_v256
+#else
+static inline void nt_store_s4(void *p, const void *v) { memcpy(p, v, 4); }
+static inline void nt_store_s8(void *p, const void *v) { memcpy(p, v, 8); }
+static inline void nt_store_v128(void *p, const void *v) { memcpy(p, v, 16); }
+static inline void nt_store_v256(void *p, const void *v) { memcpy(p, v, 32); }
+#define NT_FENCE() do { } while (0)
+#define KTARGET_v256
+#endif
+#define KTARGET_s4
+#define KTARGET_s8
+#define KTARGET_v128
+
+// ---- variant matrix ----
+
+#define KOP_copy(X, Y) (X)
+#define KOP_add(X, Y) ((X) + (Y))
+#define KOPID_copy_u32 KERNEL_COPY
+#define KOPID_copy_u64 KERNEL_COPY
+#define KOPID_add_u32 KERNEL_ADD_U32
+#define KOPID_add_u64 KERNEL_ADD_U64
+
+#define KSTORE_0(VN, p, v) (*(vec_t *)(p) = (v))
+#define KSTORE_1(VN, p, v) nt_store_##VN((p), &(v))
+#define KFENCE_0()
+#define KFENCE_1() NT_FENCE()
+
+#define KNAME(OP, TN, VN, U, AL, NT) k_##OP##_##TN##_##VN##_u##U##_a##AL##_nt##NT
+
+/**
+ * One kernel: VB-byte vectors of T, U vectors per iteration, vector-aligned
+ * loads/stores if AL, non-temporal stores if NT. The tail is done in T-sized steps.
+ */
+#define DEFINE_KERNEL(OP, T, TN, VN, VB, U, AL, NT)                                      \
+    KTARGET_##VN static void KNAME(OP, TN, VN, U, AL, NT)(void *dst, const void *a,       \
+                                                          const void *b, size_t bytes) { \
+        typedef T vec_t __attribute__((vector_size(VB), aligned((AL) ? (VB) : sizeof(T)))); \
+        uint8_t *d = (uint8_t *)dst;                                                      \
+        const uint8_t *x = (const uint8_t *)a, *y = (const uint8_t *)b;                   \
+        size_t i = 0;                                                                     \
+        (void)y;                                                                          \
+        for (; i + (VB) * (U) <= bytes; i += (VB) * (U)) {                                \
+            _Pragma("GCC unroll 8")                                                       \
+            for (int u = 0; u < (U); u++) {                                               \
+                vec_t v = KOP_##OP(*(const vec_t *)(x + i + u * (VB)),                    \
+                                   *(const vec_t *)(y + i + u * (VB)));                   \
+                KSTORE_##NT(VN, d + i + u * (VB), v);                                     \
+            }                                                                             \
+        }                                                                                 \
+        KFENCE_##NT();                                                                    \
+        for (; i + sizeof(T) <= bytes; i += sizeof(T)) {                                  \
+            T s;                                                                          \
+            memcpy(&s, x + i, sizeof(T));                                                 \
+            if (KOPID_##OP##_##TN != KERNEL_COPY) {                                       \
+                T t;                                                                      \
+                memcpy(&t, y + i, sizeof(T));                                             \
+                s += t;                                                                   \
+            }                                                                             \
+            memcpy(d + i, &s, sizeof(T));                                                 \
+        }                                                                                 \
+    }
+
+#define REGISTER_KERNEL(OP, T, TN, VN, VB, U, AL, NT) \
+    {#OP "_" #TN "_" #VN "_u" #U "_a" #AL "_nt" #NT, KOPID_##OP##_##TN, sizeof(T), VB, U, AL, NT, \
+     KNAME(OP, TN, VN, U, AL, NT)},
+
+// Non-temporal stores are only generated for aligned variants.
+#define FOR_STORE(X, OP, T, TN, VN, VB, U) \
+    X(OP, T, TN, VN, VB, U, 0, 0) X(OP, T, TN, VN, VB, U, 1, 0) X(OP, T, TN, VN, VB, U, 1, 1)
+#define FOR_UNROLL(X, OP, T, TN, VN, VB) \
+    FOR_STORE(X, OP, T, TN, VN, VB, 1) FOR_STORE(X, OP, T, TN, VN, VB, 2) FOR_STORE(X, OP, T, TN, VN, VB, 4)
+#define FOR_WIDTH(X, OP, T, TN, SN) \
+    FOR_UNROLL(X, OP, T, TN, SN, sizeof(T)) FOR_UNROLL(X, OP, T, TN, v128, 16) FOR_UNROLL(X, OP, T, TN, v256, 32)
+#define FOR_TYPE(X, OP) FOR_WIDTH(X, OP, uint32_t, u32, s4) FOR_WIDTH(X, OP, uint64_t, u64, s8)
+#define KERNEL_MATRIX(X) FOR_TYPE(X, copy) FOR_TYPE(X, add)
+
+KERNEL_MATRIX(DEFINE_KERNEL)
+
+static const kernel_variant_t g_variants[] = {
+    KERNEL_MATRIX(REGISTER_KERNEL)
+};
+#define VARIANT_COUNT ((int)(sizeof(g_variants) / sizeof(g_variants[0])))
+
+static const char *op_names[KERNEL_OP_COUNT] = {"copy", "add_u32", "add_u64"};
+
+// [op][aligned][large]
+static const kernel_variant_t *g_selected[KERNEL_OP_COUNT][2][2];
+
+// ---- feature detection ----
+
+/**
+ * @brief Detects SIMD features of the running CPU (cached after first call).
+ */
+unsigned kernel_cpu_features(void) {
+    static int probed;
+    static unsigned features;
+    if (probed) return features;
+    probed = 1;
+
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("sse2")) features |= KF_SSE2;
+    if (__builtin_cpu_supports("avx2")) features |= KF_AVX2;
+#elif defined(__aarch64__)
+    unsigned long hw = getauxval(AT_HWCAP);
+    if (hw & HWCAP_ASIMD) features |= KF_NEON;
+#ifdef HWCAP_SVE
+    if (hw & HWCAP_SVE) features |= KF_SVE;
+#endif
+#elif defined(__arm__)
+    if (getauxval(AT_HWCAP) & HWCAP_ARM_NEON) features |= KF_NEON;
+#endif
+    return features;
+}
+
+static void feature_string(unsigned f, char *buf, size_t size) {
+    snprintf(buf, size, "%s%s%s%s", (f & KF_SSE2) ? " sse2" : "", (f & KF_AVX2) ? " avx2" : "",
+             (f & KF_NEON) ? " neon" : "", (f & KF_SVE) ? " sve" : "");
+    if (buf[0]) memmove(buf, buf + 1, strlen(buf));
+    else snprintf(buf, size, "scalar");
+}
+
+/**
+ * @brief Returns non-zero if @p v can run on a CPU with @p features.
+ * @note SVE is reported but has no dedicated variants; SVE boards use NEON.
+ */
+int kernel_variant_supported(const kernel_variant_t *v, unsigned features) {
+#if defined(__x86_64__) || defined(__i386__)
+    if (v->vec_bytes == 32) return (features & KF_AVX2) != 0;
+    if (v->vec_bytes == 16) return (features & KF_SSE2) != 0;
+    return 1;
+#elif defined(__aarch64__)
+    int scalar = v->vec_bytes == v->elem_size;
+    if (v->nontemporal && scalar) return 0;
+    return scalar || (features & KF_NEON);
+#elif defined(__arm__)
+    int scalar = v->vec_bytes == v->elem_size;
+    if (v->nontemporal) return 0;
+    return scalar || (features & KF_NEON);
+#else
+    return v->vec_bytes == v->elem_size && !v->nontemporal;
+#endif
+}
+
+// ---- selection ----
+
+/**
+ * @brief Static preference used when nothing is cached: widest supported
+ *        vector, 4x unroll, streaming stores only for DRAM-sized buffers.
+ */
+static const kernel_variant_t *pick_default(kernel_op_t op, int aligned, int large, unsigned features) {
+    const kernel_variant_t *best = NULL;
+    int best_score = -1;
+    for (int i = 0; i < VARIANT_COUNT; i++) {
+        const kernel_variant_t *v = &g_variants[i];
+        if (v->op != op || v->aligned != aligned || !kernel_variant_supported(v, features)) continue;
+        if (v->nontemporal && !large) continue;
+        int score = v->vec_bytes * 8 + (v->unroll == 4 ? 4 : v->unroll) + (v->nontemporal ? 2 : 0) +
+                    (v->elem_size == 8);
+        if (score > best_score) { best_score = score; best = v; }
+    }
+    return best;
+}
+
+static const kernel_variant_t *find_variant(const char *name) {
+    for (int i = 0; i < VARIANT_COUNT; i++)
+        if (!strcmp(g_variants[i].name, name)) return &g_variants[i];
+    return NULL;
+}
+
+/**
+ * @brief Identifies the board for the tuning cache: device-tree model on a
+ *        Pi, CPU model name elsewhere, plus the detected feature set.
+ */
+static void board_key(char *key, size_t size) {
+    char model[128] = "unknown", feats[64];
+    FILE *fp = fopen("/sys/firmware/devicetree/base/model", "r");
+    if (fp) {
+        if (!fgets(model, sizeof(model), fp)) strcpy(model, "unknown");
+        fclose(fp);
+    } else if ((fp = fopen("/proc/cpuinfo", "r"))) {
+        char line[256];
+        while (fgets(line, sizeof(line), fp)) {
+            char *colon = strchr(line, ':');
+            if (colon && !strncmp(line, "model name", 10)) {
+                snprintf(model, sizeof(model), "%s", colon + 2);
+                break;
+            }
+        }
+        fclose(fp);
+    }
+    model[strcspn(model, "\n")] = 0;
+    for (char *c = model; *c; c++) if (*c == '\t') *c = ' ';
+    feature_string(kernel_cpu_features(), feats, sizeof(feats));
+    snprintf(key, size, "%s [%s]", model, feats);
+}
+
+/**
+ * @brief Loads winners for this board from KERNEL_TUNE_FILE. Returns the
+ *        number of slots filled.
+ */
+static int load_tune_cache(const char *key) {
+    FILE *fp = fopen(KERNEL_TUNE_FILE, "r");
+    int filled = 0;
+    if (!fp) return 0;
+
+    char line[512];
+    while (fgets(line, sizeof(line), fp)) {
+        line[strcspn(line, "\n")] = 0;
+        char *board = strtok(line, "\t"), *op = strtok(NULL, "\t"), *al = strtok(NULL, "\t");
+        char *lg = strtok(NULL, "\t"), *name = strtok(NULL, "\t");
+        if (!board || !op || !al || !lg || !name || strcmp(board, key)) continue;
+
+        const kernel_variant_t *v = find_variant(name);
+        int o = atoi(op), a = atoi(al) != 0, l = atoi(lg) != 0;
+        if (!v || o < 0 || o >= KERNEL_OP_COUNT) continue;
+        kernel_op_t kop = (kernel_op_t)o;
+        if (v->op == kop && v->aligned == a && kernel_variant_supported(v, kernel_cpu_features())) {
+            g_selected[kop][a][l] = v;
+            filled++;
+        }
+    }
+    fclose(fp);
+    return filled;
+}
+
+/**
+ * @brief Rewrites KERNEL_TUNE_FILE, keeping entries of other boards.
+ */
+static void save_tune_cache(const char *key) {
+    char *keep = NULL;
+    size_t keep_len = 0;
+    FILE *fp = fopen(KERNEL_TUNE_FILE, "r");
+    if (fp) {
+        char line[512];
+        size_t key_len = strlen(key);
+        while (fgets(line, sizeof(line), fp)) {
+            if (!strncmp(line, key, key_len) && line[key_len] == '\t') continue;
+            size_t n = strlen(line);
+            char *grown = realloc(keep, keep_len + n + 1);
+            if (!grown) break;
+            keep = grown;
+            memcpy(keep + keep_len, line, n + 1);
+            keep_len += n;
+        }
+        fclose(fp);
+    }
+
+    fp = fopen(KERNEL_TUNE_FILE, "w");
+    if (fp) {
+        if (keep) fputs(keep, fp);
+        for (int o = 0; o < KERNEL_OP_COUNT; o++)
+            for (int a = 0; a < 2; a++)
+                for (int l = 0; l < 2; l++)
+                    if (g_selected[o][a][l])
+                        fprintf(fp, "%s\t%d\t%d\t%d\t%s\n", key, o, a, l, g_selected[o][a][l]->name);
+        fclose(fp);
+    }
+    free(keep);
+}
+
+typedef struct {
+    const kernel_variant_t *v;
+    uint8_t *dst, *a, *b;
+    size_t bytes;
+} tune_ctx_t;
+
+static void tune_body(void *ctx, long iterations) {
+    tune_ctx_t *t = (tune_ctx_t *)ctx;
+    for (long i = 0; i < iterations; i++) {
+        t->v->fn(t->dst, t->a, t->b, t->bytes);
+        __asm__ volatile("" : : "r"(t->dst) : "memory");
+    }
+}
+
+/**
+ * @brief Median GB/s written by @p v on buffers of @p bytes. Unaligned
+ *        variants run 8 bytes off vector alignment.
+ */
+static double tune_variant(const kernel_variant_t *v, uint8_t *dst, uint8_t *a, uint8_t *b, size_t bytes) {
+    int off = v->aligned ? 0 : 8;
+    tune_ctx_t t = {v, dst + off, a + off, b + off, bytes};
+    bench_stats_t st;
+    long iterations = (long)(64 * 1024 * 1024 / bytes);
+    bench_measure(tune_body, &t, iterations > 0 ? iterations : 1, TUNE_SAMPLES, &st);
+    return (bytes / (1024.0 * 1024.0 * 1024.0)) / (st.median / 1e9);
+}
+
+static void autotune(FILE *log_fp) {
+    uint8_t *dst = NULL, *a = NULL, *b = NULL;
+    size_t alloc = TUNE_LARGE_BYTES + 64;
+    unsigned features = kernel_cpu_features();
+    double best[KERNEL_OP_COUNT][2][2];
+    memset(best, 0, sizeof(best));
+
+    if (posix_memalign((void **)&dst, 64, alloc) || posix_memalign((void **)&a, 64, alloc) ||
+        posix_memalign((void **)&b, 64, alloc)) {
+        free(dst); free(a); free(b);
+        return;
+    }
+    memset(dst, 0, alloc);
+    memset(a, 1, alloc);
+    memset(b, 2, alloc);
+
+    fprintf(log_fp, "%-28s %12s %12s\n", "Variant", "L2 GB/s", "DRAM GB/s");
+    printf("Tuning %d kernel variants...\n", VARIANT_COUNT);
+    for (int i = 0; i < VARIANT_COUNT; i++) {
+        const kernel_variant_t *v = &g_variants[i];
+        if (!kernel_variant_supported(v, features)) continue;
+
+        double gbs[2];
+        gbs[0] = tune_variant(v, dst, a, b, TUNE_SMALL_BYTES);
+        gbs[1] = tune_variant(v, dst, a, b, TUNE_LARGE_BYTES);
+        fprintf(log_fp, "%-28s %12.2f %12.2f\n", v->name, gbs[0], gbs[1]);
+        for (int l = 0; l < 2; l++) {
+            if (gbs[l] > best[v->op][v->aligned][l]) {
+                best[v->op][v->aligned][l] = gbs[l];
+                g_selected[v->op][v->aligned][l] = v;
+            }
+        }
+    }
+    free(dst); free(a); free(b);
+}
+
+/**
+ * @brief Chooses the variant used for each op/alignment/size class.
+ */
+void kernel_select(int autotune_now, FILE *log_fp) {
+    char key[256];
+    unsigned features = kernel_cpu_features();
+    board_key(key, sizeof(key));
+
+    memset(g_selected, 0, sizeof(g_selected));
+    if (autotune_now) {
+        autotune(log_fp);
+        save_tune_cache(key);
+    } else {
+        load_tune_cache(key);
+    }
+
+    for (int o = 0; o < KERNEL_OP_COUNT; o++)
+        for (int a = 0; a < 2; a++)
+            for (int l = 0; l < 2; l++)
+                if (!g_selected[o][a][l]) g_selected[o][a][l] = pick_default(o, a, l, features);
+}
+
+/**
+ * @brief Returns the variant kernel_run() would use.
+ */
+const kernel_variant_t *kernel_selected(kernel_op_t op, int aligned, int large) {
+    if (!g_selected[op][aligned != 0][large != 0]) kernel_select(0, stdout);
+    return g_selected[op][aligned != 0][large != 0];
+}
+
+/**
+ * @brief Runs the selected variant. Aligned variants need every pointer on a
+ *        32-byte boundary; other calls get the best unaligned variant.
+ */
+void kernel_run(kernel_op_t op, void *dst, const void *a, const void *b, size_t bytes) {
+    uintptr_t addr = (uintptr_t)dst | (uintptr_t)a | (op == KERNEL_COPY ? 0 : (uintptr_t)b);
+    const kernel_variant_t *v = kernel_selected(op, (addr & 31) == 0, bytes > KERNEL_LARGE_BYTES);
+    v->fn(dst, a, b, bytes);
+}
+
+/**
+ * @brief Logs detected features and the selected variants (Part E).
+ */
+void run_kernel_library_report(FILE *log_fp, int autotune_now) {
+    char feats[64], key[256];
+    fprintf(log_fp, "\n[Part E: Kernel Library]\n");
+    printf("\nSelecting Kernel Variants...\n");
+
+    feature_string(kernel_cpu_features(), feats, sizeof(feats));
+    board_key(key, sizeof(key));
+    fprintf(log_fp, "CPU features       : %s\n", feats);
+    fprintf(log_fp, "Variants compiled  : %d\n", VARIANT_COUNT);
+    printf("CPU features: %s | %d variants compiled\n", feats, VARIANT_COUNT);
+
+    kernel_select(autotune_now, log_fp);
+
+    fprintf(log_fp, "Selected (%s%s):\n", key, autotune_now ? ", tuned" : "");
+    for (int o = 0; o < KERNEL_OP_COUNT; o++)
+        for (int a = 0; a < 2; a++)
+            for (int l = 0; l < 2; l++) {
+                const kernel_variant_t *v = g_selected[o][a][l];
+                fprintf(log_fp, "  %-8s %-9s %-5s: %s\n", op_names[o], a ? "aligned" : "unaligned",
+                        l ? "DRAM" : "L2", v ? v->name : "none");
+                printf("  %-8s %-9s %-5s: %s\n", op_names[o], a ? "aligned" : "unaligned",
+                       l ? "DRAM" : "L2", v ? v->name : "none");
+            }
+}
@@ -0,0 +1,77 @@
+#ifndef KERNELS_H
+#define KERNELS_H
+
+#include <stdio.h>
+#include <stddef.h>
+
+#define KERNEL_LARGE_BYTES (1024 * 1024) // above this the DRAM winner is used
+#define KERNEL_TUNE_FILE "kernel_tune.txt"
+
+typedef enum {
+    KERNEL_COPY,    // dst = a
+    KERNEL_ADD_U32, // dst = a + b, 32-bit lanes
+    KERNEL_ADD_U64, // dst = a + b, 64-bit lanes
+    KERNEL_OP_COUNT
+} kernel_op_t;
+
+enum {
+    KF_SSE2 = 1 << 0,
+    KF_AVX2 = 1 << 1,
+    KF_NEON = 1 << 2, // NEON on armv7, ASIMD on aarch64
+    KF_SVE  = 1 << 3,
+};
+
+typedef void (*kernel_fn_t)(void *dst, const void *a, const void *b, size_t bytes);
+
+/**
+ * @brief One compile-time specialisation of a streaming kernel.
+ * @details vec_bytes == elem_size means scalar. Non-temporal variants always
+ *          assume vector-aligned pointers.
+ */
+typedef struct {
+    const char *name;
+    kernel_op_t op;
+    int elem_size;
+    int vec_bytes;
+    int unroll;
+    int aligned;
+    int nontemporal;
+    kernel_fn_t fn;
+} kernel_variant_t;
+
+/**
+ * @brief Detects SIMD features of the running CPU (cached after first call).
+ */
+unsigned kernel_cpu_features(void);
+
+/**
+ * @brief Returns non-zero if @p v can run on a CPU with @p features.
+ */
+int kernel_variant_supported(const kernel_variant_t *v, unsigned features);
+
+/**
+ * @brief Chooses the variant used for each op/alignment/size class.
+ * @details With @p autotune set every supported variant is benchmarked, the
+ *          table is written to @p log_fp and the winners are cached in
+ *          KERNEL_TUNE_FILE for this board. Otherwise a cached result for this
+ *          board is loaded, falling back to a static preference.
+ */
+void kernel_select(int autotune, FILE *log_fp);
+
+/**
+ * @brief Returns the variant kernel_run() would use.
+ */
+const kernel_variant_t *kernel_selected(kernel_op_t op, int aligned, int large);
+
+/**
+ * @brief Runs the selected variant. @p bytes should be a multiple of 8;
+ *        @p b is ignored for KERNEL_COPY.
+ */
+void kernel_run(kernel_op_t op, void *dst, const void *a, const void *b, size_t bytes);
+
+/**
+ * @brief Logs detected features and the selected variants (Part E).
+ */
+void run_kernel_library_report(FILE *log_fp, int autotune);
+
+#endif
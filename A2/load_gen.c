@@ -0,0 +1,353 @@
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <time.h>
+#include <errno.h>
+
+#include "bench_stats.h"
+#include "load_gen.h"
+
+#define LOAD_L1_SIZE (16 * 1024)          // 16KB
+#define LOAD_L2_SIZE (512 * 1024)         // 512KB
+#define LOAD_DRAM_SIZE (32 * 1024 * 1024) // 32MB
+#define LOAD_LEGACY_SIZE (10 * 1024 * 1024) // 10MB, as the old stress_worker
+#define LOAD_SLICE (256 * 1024)           // bytes streamed per DRAM/legacy quantum
+
+typedef struct {
+    const char *name;
+    const char *unit;
+    double unit_scale;
+} load_type_info_t;
+
+static const load_type_info_t type_info[LOAD_TYPE_COUNT] = {
+    {"int", "Gop/s", 1e9},
+    {"fma", "GFLOP/s", 1e9},
+    {"l1", "GB/s", 1e9},
+    {"l2", "GB/s", 1e9},
+    {"dram", "GB/s", 1e9},
+    {"random", "Macc/s", 1e6},
+    {"branchy", "Mbr/s", 1e6},
+    {"legacy", "GB/s", 1e9},
+    {"virus", "Miter/s", 1e6},
+};
+
+/**
+ * @brief Buffers owned by one generator thread; only the workloads in the
+ *        mix get memory.
+ */
+typedef struct {
+    uint64_t *l1, *l2, *dram;
+    uint32_t *legacy_src, *legacy_dst;
+    uint8_t *branch_data;
+    size_t l2_off, dram_off, legacy_off;
+    uint64_t rng;
+    uint64_t sink;
+    float legacy_dummy;
+} load_buffers_t;
+
+// ---- workload quanta: each does ~10-100us of work and returns units done ----
+
+static uint64_t quantum_int(load_buffers_t *b) {
+    uint64_t x0 = b->rng, x1 = x0 ^ 0x9E37, x2 = x0 + 7, x3 = x0 * 3;
+    for (int i = 0; i < 4096; i++) {
+        x0 = x0 * 6364136223846793005ULL + 1;
+        x1 = (x1 ^ (x1 >> 7)) + x0;
+        x2 = (x2 << 3) ^ (x2 + x1);
+        x3 = x3 * 0x5851F42D + x2;
+    }
+    b->sink += x0 ^ x1 ^ x2 ^ x3;
+    return 4096 * 10;
+}
+
+static uint64_t quantum_fma(load_buffers_t *b) {
+    typedef float v4f __attribute__((vector_size(16)));
+    v4f a0 = {1, 2, 3, 4}, a1 = a0 + 1, a2 = a0 + 2, a3 = a0 + 3;
+    v4f a4 = a0 + 4, a5 = a0 + 5, a6 = a0 + 6, a7 = a0 + 7;
+    const v4f m = {0.999f, 0.999f, 0.999f, 0.999f}, c = {0.001f, 0.001f, 0.001f, 0.001f};
+    for (int i = 0; i < 2048; i++) {
+        a0 = a0 * m + c; a1 = a1 * m + c; a2 = a2 * m + c; a3 = a3 * m + c;
+        a4 = a4 * m + c; a5 = a5 * m + c; a6 = a6 * m + c; a7 = a7 * m + c;
+    }
+    v4f s = a0 + a1 + a2 + a3 + a4 + a5 + a6 + a7;
+    b->sink += (uint64_t)(s[0] + s[1] + s[2] + s[3]);
+    return 2048ULL * 8 * 4 * 2;
+}
+
+static uint64_t rmw_buffer(uint64_t *buf, size_t bytes, uint64_t *sink) {
+    uint64_t acc = 0;
+    for (size_t i = 0; i < bytes / 8; i++) {
+        acc += buf[i];
+        buf[i] = acc;
+    }
+    *sink += acc;
+    return bytes * 2;
+}
+
+static uint64_t quantum_l1(load_buffers_t *b) {
+    uint64_t bytes = 0;
+    for (int r = 0; r < 8; r++) bytes += rmw_buffer(b->l1, LOAD_L1_SIZE, &b->sink);
+    return bytes;
+}
+
+static uint64_t quantum_l2(load_buffers_t *b) {
+    uint64_t bytes = rmw_buffer(b->l2 + b->l2_off / 8, LOAD_L2_SIZE / 4, &b->sink);
+    b->l2_off = (b->l2_off + LOAD_L2_SIZE / 4) % LOAD_L2_SIZE;
+    return bytes;
+}
+
+static uint64_t quantum_dram(load_buffers_t *b) {
+    uint8_t *base = (uint8_t *)b->dram;
+    size_t half = LOAD_DRAM_SIZE / 2;
+    memcpy(base + half + b->dram_off, base + b->dram_off, LOAD_SLICE);
+    __asm__ volatile("" : : "r"(base) : "memory");
+    b->dram_off = (b->dram_off + LOAD_SLICE) % half;
+    return LOAD_SLICE * 2;
+}
+
+static uint64_t quantum_random(load_buffers_t *b) {
+    uint64_t x = b->rng, acc = 0;
+    size_t n = LOAD_DRAM_SIZE / 8;
+    for (int i = 0; i < 1024; i++) {
+        x = x * 6364136223846793005ULL + 1442695040888963407ULL;
+        acc += b->dram[(x >> 20) % n];
+    }
+    b->rng = x;
+    b->sink += acc;
+    return 1024;
+}
+
+/**
+ * @brief Branches on random bytes; half of them mispredict on any predictor.
+ */
+__attribute__((optimize("no-if-conversion", "no-tree-loop-if-convert")))
+static uint64_t quantum_branchy(load_buffers_t *b) {
+    uint64_t acc = 0;
+    for (int i = 0; i < 4096; i++) {
+        uint8_t v = b->branch_data[i];
+        if (v & 1) acc += v;
+        else acc ^= (uint64_t)v << 3;
+        if (v & 2) acc *= 3;
+    }
+    b->sink += acc;
+    return 4096 * 2;
+}
+
+static uint64_t quantum_legacy(load_buffers_t *b) {
+    uint32_t *src = b->legacy_src + b->legacy_off / 4, *dst = b->legacy_dst + b->legacy_off / 4;
+    volatile float dummy = b->legacy_dummy;
+    for (int i = 0; i < LOAD_SLICE / 4; i++) {
+        dst[i] = src[i];
+        dummy = (dummy / 1.000001f) + 0.00001f;
+    }
+    b->legacy_dummy = dummy;
+    b->legacy_off = (b->legacy_off + LOAD_SLICE) % LOAD_LEGACY_SIZE;
+    return LOAD_SLICE * 2;
+}
+
+/**
+ * @brief One loop body feeds the FP/SIMD, integer and load/store pipes at
+ *        once, so none of them idles while another works: worst-case heat.
+ */
+static uint64_t quantum_virus(load_buffers_t *b) {
+    typedef float v4f __attribute__((vector_size(16)));
+    v4f a0 = {1, 2, 3, 4}, a1 = a0 + 1, a2 = a0 + 2, a3 = a0 + 3;
+    v4f a4 = a0 + 4, a5 = a0 + 5, a6 = a0 + 6, a7 = a0 + 7;
+    const v4f m = {0.999f, 0.999f, 0.999f, 0.999f}, c = {0.001f, 0.001f, 0.001f, 0.001f};
+    uint64_t x0 = b->rng, x1 = x0 ^ 0x9E37, x2 = x0 + 7, x3 = x0 * 3;
+    uint64_t *l1 = b->l1;
+    const size_t mask = LOAD_L1_SIZE / 8 - 1;
+    for (size_t i = 0; i < 2048; i++) {
+        a0 = a0 * m + c; a1 = a1 * m + c; a2 = a2 * m + c; a3 = a3 * m + c;
+        x0 = x0 * 6364136223846793005ULL + 1;
+        x1 = (x1 ^ (x1 >> 7)) + x0;
+        x3 += l1[i & mask] ^ l1[(i * 7) & mask];
+        a4 = a4 * m + c; a5 = a5 * m + c; a6 = a6 * m + c; a7 = a7 * m + c;
+        x2 = (x2 << 3) ^ (x2 + x1);
+        l1[(i + 512) & mask] = x3 + x2;
+    }
+    v4f s = a0 + a1 + a2 + a3 + a4 + a5 + a6 + a7;
+    b->sink += (uint64_t)(s[0] + s[1] + s[2] + s[3]) ^ x0 ^ x1 ^ x2 ^ x3;
+    return 2048;
+}
+
+typedef uint64_t (*quantum_fn_t)(load_buffers_t *b);
+static const quantum_fn_t quanta[LOAD_TYPE_COUNT] = {
+    quantum_int, quantum_fma, quantum_l1, quantum_l2,
+    quantum_dram, quantum_random, quantum_branchy, quantum_legacy,
+    quantum_virus,
+};
+
+static int buffers_alloc(load_buffers_t *b, unsigned mix, int id) {
+    memset(b, 0, sizeof(*b));
+    b->rng = 0x853C49E6748FEA9BULL ^ ((uint64_t)id << 32);
+    b->legacy_dummy = 1.414f;
+    if (mix & ((1u << LOAD_L1) | (1u << LOAD_VIRUS)) && !(b->l1 = calloc(1, LOAD_L1_SIZE))) return -1;
+    if (mix & (1u << LOAD_L2) && !(b->l2 = calloc(1, LOAD_L2_SIZE))) return -1;
+    if (mix & ((1u << LOAD_DRAM) | (1u << LOAD_RANDOM))) {
+        if (!(b->dram = malloc(LOAD_DRAM_SIZE))) return -1;
+        memset(b->dram, 0x5A, LOAD_DRAM_SIZE);
+    }
+    if (mix & (1u << LOAD_LEGACY)) {
+        b->legacy_src = calloc(1, LOAD_LEGACY_SIZE);
+        b->legacy_dst = calloc(1, LOAD_LEGACY_SIZE);
+        if (!b->legacy_src || !b->legacy_dst) return -1;
+    }
+    if (mix & (1u << LOAD_BRANCHY)) {
+        if (!(b->branch_data = malloc(4096))) return -1;
+        uint64_t x = b->rng;
+        for (int i = 0; i < 4096; i++) {
+            x = x * 6364136223846793005ULL + 1442695040888963407ULL;
+            b->branch_data[i] = (uint8_t)(x >> 56);
+        }
+    }
+    return 0;
+}
+
+static void buffers_free(load_buffers_t *b) {
+    free(b->l1); free(b->l2); free(b->dram);
+    free(b->legacy_src); free(b->legacy_dst); free(b->branch_data);
+}
+
+/**
+ * @brief Busy fraction (0..1) of the profile at @p t_sec into the run.
+ */
+static double profile_duty(const load_config_t *cfg, double t_sec) {
+    double pct;
+    switch (cfg->profile) {
+    case PROFILE_RAMP: {
+        double f = cfg->duration_sec > 0 ? t_sec / cfg->duration_sec : 1.0;
+        if (f > 1.0) f = 1.0;
+        pct = cfg->ramp_start_pct + (cfg->ramp_end_pct - cfg->ramp_start_pct) * f;
+        break;
+    }
+    case PROFILE_STEP: {
+        int step = cfg->step_sec > 0 ? (int)(t_sec / cfg->step_sec) : 0;
+        if (cfg->num_steps <= 0) { pct = 100; break; }
+        if (step >= cfg->num_steps) step = cfg->num_steps - 1;
+        pct = cfg->steps_pct[step];
+        break;
+    }
+    default:
+        pct = cfg->duty_pct;
+        break;
+    }
+    if (pct < 0) pct = 0;
+    if (pct > 100) pct = 100;
+    return pct / 100.0;
+}
+
+static void sleep_until_ns(double t_ns) {
+    int64_t ns = (int64_t)t_ns;
+    struct timespec ts = {(time_t)(ns / 1000000000), (long)(ns % 1000000000)};
+    // clock_nanosleep() returns the error code instead of setting errno
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL) == EINTR) {
+    }
+}
+
+/**
+ * @brief Generator thread body; @p args is a load_thread_t.
+ * @details PWM-style: in each period the thread works until the busy share
+ *          is used up, then sleeps to the end of the period.
+ */
+void* load_worker(void* args) {
+    load_thread_t *t = (load_thread_t *)args;
+    const load_config_t *cfg = t->cfg;
+    load_buffers_t b;
+
+    if (buffers_alloc(&b, cfg->mix, t->id) != 0 || !cfg->mix) {
+        buffers_free(&b);
+        return NULL;
+    }
+
+    double period_ns = (cfg->period_ms > 0 ? cfg->period_ms : 100) * 1e6;
+    double end_ns = t->start_ns + cfg->duration_sec * 1e9;
+    double period_start = t->start_ns;
+    int next = 0;
+
+    while (period_start < end_ns) {
+        double duty = profile_duty(cfg, (period_start - t->start_ns) / 1e9);
+        double busy_end = period_start + duty * period_ns;
+        if (busy_end > end_ns) busy_end = end_ns;
+
+        double now = bench_now_ns();
+        while (now < busy_end) {
+            while (!(cfg->mix & (1u << next))) next = (next + 1) % LOAD_TYPE_COUNT;
+            t->units[next] += quanta[next](&b);
+            double after = bench_now_ns();
+            t->busy_ns[next] += after - now;
+            now = after;
+            next = (next + 1) % LOAD_TYPE_COUNT;
+        }
+
+        period_start += period_ns;
+        if (duty < 1.0 && period_start < end_ns) sleep_until_ns(period_start);
+    }
+
+    t->elapsed_ns = bench_now_ns() - t->start_ns;
+    __asm__ volatile("" : : "r"(b.sink));
+    buffers_free(&b);
+    return NULL;
+}
+
+static int type_from_name(const char *name, size_t len) {
+    for (int i = 0; i < LOAD_TYPE_COUNT; i++)
+        if (strlen(type_info[i].name) == len && !strncmp(type_info[i].name, name, len)) return i;
+    return -1;
+}
+
+/**
+ * @brief Fills @p cfg from the config.txt strings.
+ */
+int load_config_parse(load_config_t *cfg, const char *profile, const char *mix, const char *steps) {
+    cfg->mix = 0;
+    cfg->num_steps = 0;
+
+    if (!strcmp(profile, "power_virus")) {
+        // Fused FMA + integer ALU + L1 quantum at 100% duty: worst-case heat.
+        cfg->profile = PROFILE_CONSTANT;
+        cfg->duty_pct = 100;
+        cfg->mix = 1u << LOAD_VIRUS;
+        return 0;
+    }
+    if (!strcmp(profile, "constant")) cfg->profile = PROFILE_CONSTANT;
+    else if (!strcmp(profile, "ramp")) cfg->profile = PROFILE_RAMP;
+    else if (!strcmp(profile, "step")) cfg->profile = PROFILE_STEP;
+    else return -1;
+
+    for (const char *p = mix; *p;) {
+        size_t len = strcspn(p, ",");
+        int type = type_from_name(p, len);
+        if (type < 0) return -1;
+        cfg->mix |= 1u << type;
+        p += len + (p[len] == ',');
+    }
+
+    for (const char *p = steps; *p && cfg->num_steps < LOAD_MAX_STEPS;) {
+        cfg->steps_pct[cfg->num_steps++] = atoi(p);
+        p += strcspn(p, ",");
+        if (*p == ',') p++;
+    }
+    return cfg->mix ? 0 : -1;
+}
+
+/**
+ * @brief Writes achieved duty cycle and per-workload work rates of each thread.
+ * @details A rate is units per second of busy time spent in that workload.
+ */
+void load_report(FILE *fp, const load_thread_t *threads, int num_threads) {
+    for (int i = 0; i < num_threads; i++) {
+        const load_thread_t *t = &threads[i];
+        double busy = 0;
+        for (int k = 0; k < LOAD_TYPE_COUNT; k++) busy += t->busy_ns[k];
+
+        fprintf(fp, "Thread %d: duty %5.1f%%", t->id, t->elapsed_ns > 0 ? 100.0 * busy / t->elapsed_ns : 0);
+        for (int k = 0; k < LOAD_TYPE_COUNT; k++) {
+            if (!(t->cfg->mix & (1u << k)) || t->busy_ns[k] <= 0) continue;
+            fprintf(fp, " | %s %.2f %s", type_info[k].name,
+                    t->units[k] / (t->busy_ns[k] / 1e9) / type_info[k].unit_scale, type_info[k].unit);
+        }
+        fprintf(fp, "\n");
+    }
+}
@@ -0,0 +1,78 @@
+#ifndef LOAD_GEN_H
+#define LOAD_GEN_H
+
+#include <stdio.h>
+#include <stdint.h>
+
+#define LOAD_MAX_STEPS 16
+
+typedef enum {
+    LOAD_INT,     // integer ALU chains
+    LOAD_FMA,     // FP multiply-add on 128-bit vectors (NEON on the Pi)
+    LOAD_L1,      // read-modify-write of a 16KB buffer
+    LOAD_L2,      // read-modify-write of a 512KB buffer
+    LOAD_DRAM,    // streaming copy through 32MB
+    LOAD_RANDOM,  // independent random reads over 32MB
+    LOAD_BRANCHY, // data-dependent, unpredictable branches
+    LOAD_LEGACY,  // original stress_worker: 10MB copy + dependent divide
+    LOAD_VIRUS,   // FMA, integer chains and L1 loads/stores fused in one loop
+    LOAD_TYPE_COUNT
+} load_type_t;
+
+typedef enum {
+    PROFILE_CONSTANT,
+    PROFILE_RAMP,
+    PROFILE_STEP
+} load_profile_t;
+
+/**
+ * @brief Load shape shared by all generator threads.
+ * @details Each thread runs the workloads in @c mix round-robin for the busy
+ *          part of every @c period_ms window and sleeps for the rest; the
+ *          busy fraction follows the profile over time.
+ */
+typedef struct {
+    unsigned mix;            // bitmask of (1 << load_type_t)
+    load_profile_t profile;
+    int duty_pct;            // PROFILE_CONSTANT
+    int ramp_start_pct;      // PROFILE_RAMP
+    int ramp_end_pct;
+    int steps_pct[LOAD_MAX_STEPS]; // PROFILE_STEP
+    int num_steps;
+    int step_sec;
+    int period_ms;
+    int duration_sec;
+} load_config_t;
+
+/**
+ * @brief Per-thread arguments and results of load_worker().
+ */
+typedef struct {
+    const load_config_t *cfg;
+    int id;
+    double start_ns;
+    uint64_t units[LOAD_TYPE_COUNT];
+    double busy_ns[LOAD_TYPE_COUNT];
+    double elapsed_ns;
+} load_thread_t;
+
+/**
+ * @brief Fills @p cfg from the config.txt strings.
+ * @param profile "constant", "ramp", "step" or "power_virus".
+ * @param mix Comma-separated workload names, e.g. "int,fma,l1".
+ * @param steps Comma-separated duty levels in percent for "step".
+ * @return int 0 on success, -1 if a name is not recognised.
+ */
+int load_config_parse(load_config_t *cfg, const char *profile, const char *mix, const char *steps);
+
+/**
+ * @brief Generator thread body; @p args is a load_thread_t.
+ */
+void* load_worker(void* args);
+
+/**
+ * @brief Writes achieved duty cycle and per-workload work rates of each thread.
+ */
+void load_report(FILE *fp, const load_thread_t *threads, int num_threads);
+
+#endif
@@ -0,0 +1,23 @@
+#ifndef MONITOR_H
+#define MONITOR_H
+
+/**
+ * @brief Settings for the continuous telemetry daemon.
+ * @details When socket_path is non-empty the metrics are served on that Unix
+ *          domain socket, otherwise on 127.0.0.1:port.
+ */
+typedef struct {
+    int port;
+    char socket_path[108];
+    int interval_ms;
+    int probe_interval_sec;
+} monitor_config_t;
+
+/**
+ * @brief Samples temperature, clocks and throttle state until SIGINT/SIGTERM
+ *        and serves the latest sample in Prometheus text format over HTTP.
+ * @return int 0 on clean shutdown, 1 if the listening socket cannot be set up.
+ */
+int run_monitor_daemon(const monitor_config_t *cfg);
+
+#endif
@@ -0,0 +1,296 @@
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <stdint.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sched.h>
+#include <spawn.h>
+#include <pthread.h>
+#include <sys/mman.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <sys/wait.h>
+#include <linux/futex.h>
+
+#include "bench_stats.h"
+#include "os_bench.h"
+
+#define OS_SAMPLES 30
+#define FAULT_REGION_SIZE (16 * 1024 * 1024) // 16MB
+#define FAULT_FILE "os_bench_fault.tmp"
+
+extern char **environ;
+
+typedef struct {
+    int to_partner[2];
+    int to_main[2];
+    int futex_word;
+    int use_futex;
+    int cpu;
+} pingpong_t;
+
+/**
+ * @brief Pins the calling thread to one CPU. Returns 0 on success.
+ */
+static int pin_to_cpu(int cpu) {
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    return pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+}
+
+static long futex_op(int *uaddr, int op, int val) {
+    return syscall(SYS_futex, uaddr, op, val, NULL, NULL, 0);
+}
+
+/**
+ * @brief Spins on the futex word until it leaves @p val, sleeping in the kernel.
+ */
+static int futex_wait_while(int *word, int val) {
+    int cur;
+    while ((cur = __atomic_load_n(word, __ATOMIC_ACQUIRE)) == val)
+        futex_op(word, FUTEX_WAIT_PRIVATE, val);
+    return cur;
+}
+
+static void futex_set(int *word, int val) {
+    __atomic_store_n(word, val, __ATOMIC_RELEASE);
+    futex_op(word, FUTEX_WAKE_PRIVATE, 1);
+}
+
+/**
+ * @brief Echo side of the ping-pong. Futex word: 0 = main's turn,
+ *        1 = partner's turn, 2 = stop. Pipe: byte 'q' stops.
+ */
+static void* pingpong_partner(void* args) {
+    pingpong_t *pp = (pingpong_t *)args;
+    pin_to_cpu(pp->cpu);
+
+    if (pp->use_futex) {
+        while (futex_wait_while(&pp->futex_word, 0) != 2)
+            futex_set(&pp->futex_word, 0);
+    } else {
+        char c;
+        while (read(pp->to_partner[0], &c, 1) == 1 && c != 'q') {
+            if (write(pp->to_main[1], &c, 1) != 1) break;
+        }
+    }
+    return NULL;
+}
+
+static void pingpong_round_trips(void *ctx, long iterations) {
+    pingpong_t *pp = (pingpong_t *)ctx;
+    char c = 'x';
+    for (long i = 0; i < iterations; i++) {
+        if (pp->use_futex) {
+            futex_set(&pp->futex_word, 1);
+            futex_wait_while(&pp->futex_word, 1);
+        } else {
+            if (write(pp->to_partner[1], &c, 1) != 1) return;
+            if (read(pp->to_main[0], &c, 1) != 1) return;
+        }
+    }
+}
+
+/**
+ * @brief Measures one context-switch round trip between two pinned threads.
+ * @return 0 on success, -1 if the threads could not be set up.
+ */
+static int measure_pingpong(int use_futex, int main_cpu, int partner_cpu, bench_stats_t *st) {
+    pingpong_t pp;
+    memset(&pp, 0, sizeof(pp));
+    pp.use_futex = use_futex;
+    pp.cpu = partner_cpu;
+    if (pipe(pp.to_partner) || pipe(pp.to_main)) return -1;
+
+    cpu_set_t saved;
+    pthread_getaffinity_np(pthread_self(), sizeof(saved), &saved);
+    pin_to_cpu(main_cpu);
+
+    pthread_t partner;
+    int rc = pthread_create(&partner, NULL, pingpong_partner, &pp);
+    if (rc == 0) {
+        bench_measure(pingpong_round_trips, &pp, 2000, OS_SAMPLES, st);
+        if (use_futex) {
+            futex_set(&pp.futex_word, 2);
+        } else {
+            char q = 'q';
+            if (write(pp.to_partner[1], &q, 1) != 1) pthread_cancel(partner);
+        }
+        pthread_join(partner, NULL);
+    }
+
+    pthread_setaffinity_np(pthread_self(), sizeof(saved), &saved);
+    close(pp.to_partner[0]); close(pp.to_partner[1]);
+    close(pp.to_main[0]); close(pp.to_main[1]);
+    return rc ? -1 : 0;
+}
+
+static void null_syscall(void *ctx, long iterations) {
+    (void)ctx;
+    for (long i = 0; i < iterations; i++) syscall(SYS_getppid);
+}
+
+static void vdso_clock(void *ctx, long iterations) {
+    struct timespec ts;
+    (void)ctx;
+    for (long i = 0; i < iterations; i++) {
+        clock_gettime(CLOCK_MONOTONIC, &ts);
+        __asm__ volatile("" : : "r"(&ts) : "memory");
+    }
+}
+
+static void* empty_thread(void* args) { return args; }
+
+static void thread_create_join(void *ctx, long iterations) {
+    (void)ctx;
+    for (long i = 0; i < iterations; i++) {
+        pthread_t t;
+        if (pthread_create(&t, NULL, empty_thread, NULL) == 0) pthread_join(t, NULL);
+    }
+}
+
+static void fork_wait(void *ctx, long iterations) {
+    (void)ctx;
+    for (long i = 0; i < iterations; i++) {
+        pid_t pid = fork();
+        if (pid == 0) _exit(0);
+        if (pid > 0) waitpid(pid, NULL, 0);
+    }
+}
+
+static void spawn_wait(void *ctx, long iterations) {
+    char *argv[] = {"/bin/true", NULL};
+    (void)ctx;
+    for (long i = 0; i < iterations; i++) {
+        pid_t pid;
+        if (posix_spawn(&pid, argv[0], NULL, NULL, argv, environ) == 0) waitpid(pid, NULL, 0);
+    }
+}
+
+/**
+ * @brief Cost of a first-touch (minor) fault on fresh anonymous memory, per page.
+ */
+static void measure_minor_faults(bench_stats_t *st) {
+    long page = sysconf(_SC_PAGESIZE);
+    double raw[OS_SAMPLES];
+    int n = 0;
+
+    for (int s = 0; s < OS_SAMPLES; s++) {
+        volatile uint8_t *p = mmap(NULL, FAULT_REGION_SIZE, PROT_READ | PROT_WRITE,
+                                   MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (p == MAP_FAILED) break;
+        madvise((void *)p, FAULT_REGION_SIZE, MADV_NOHUGEPAGE);
+
+        double t0 = bench_now_ns();
+        for (size_t off = 0; off < FAULT_REGION_SIZE; off += page) p[off] = 1;
+        raw[n++] = (bench_now_ns() - t0) / (FAULT_REGION_SIZE / page);
+
+        munmap((void *)p, FAULT_REGION_SIZE);
+    }
+    bench_stats_compute(raw, n, st);
+}
+
+/**
+ * @brief Cost of a major fault: a file page evicted from the page cache and
+ *        read back from storage, per fault actually reported by getrusage().
+ * @return 0 on success, -1 if no major faults could be provoked (e.g. tmpfs).
+ */
+static int measure_major_faults(bench_stats_t *st) {
+    long page = sysconf(_SC_PAGESIZE);
+    double raw[OS_SAMPLES];
+    int n = 0;
+
+    int fd = open(FAULT_FILE, O_RDWR | O_CREAT | O_TRUNC, 0600);
+    if (fd < 0) return -1;
+    unlink(FAULT_FILE);
+
+    uint8_t *chunk = malloc(page);
+    if (!chunk) { close(fd); return -1; }
+    memset(chunk, 0x5A, page);
+    for (size_t off = 0; off < FAULT_REGION_SIZE; off += page) {
+        if (write(fd, chunk, page) != page) { free(chunk); close(fd); return -1; }
+    }
+    free(chunk);
+    fsync(fd);
+
+    for (int s = 0; s < OS_SAMPLES / 3; s++) {
+        posix_fadvise(fd, 0, FAULT_REGION_SIZE, POSIX_FADV_DONTNEED);
+        volatile uint8_t *p = mmap(NULL, FAULT_REGION_SIZE, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (p == MAP_FAILED) break;
+        madvise((void *)p, FAULT_REGION_SIZE, MADV_RANDOM);
+
+        struct rusage r0, r1;
+        uint32_t sum = 0;
+        getrusage(RUSAGE_SELF, &r0);
+        double t0 = bench_now_ns();
+        for (size_t off = 0; off < FAULT_REGION_SIZE; off += page) sum += p[off];
+        double elapsed = bench_now_ns() - t0;
+        getrusage(RUSAGE_SELF, &r1);
+        __asm__ volatile("" : : "r"(sum));
+
+        long faults = r1.ru_majflt - r0.ru_majflt;
+        if (faults > 0) raw[n++] = elapsed / faults;
+        munmap((void *)p, FAULT_REGION_SIZE);
+    }
+    close(fd);
+
+    if (n == 0) return -1;
+    bench_stats_compute(raw, n, st);
+    return 0;
+}
+
+/**
+ * @brief Kernel-cost microbenchmarks (syscalls, context switches, thread and
+ *        process creation, page faults).
+ * @param log_fp Pointer to the hardware_info.txt file.
+ */
+void run_os_overhead_benchmark(FILE *log_fp) {
+    fprintf(log_fp, "\n[Part C: OS Overhead]\n");
+    printf("\nRunning OS Overhead Benchmark...\n");
+
+    bench_stats_t st;
+    int cpus = (int)sysconf(_SC_NPROCESSORS_ONLN);
+
+    bench_measure(null_syscall, NULL, 100000, OS_SAMPLES, &st);
+    bench_stats_log(log_fp, "Null syscall (getppid)", "ns", &st);
+
+    bench_measure(vdso_clock, NULL, 100000, OS_SAMPLES, &st);
+    bench_stats_log(log_fp, "clock_gettime (vDSO)", "ns", &st);
+
+    if (measure_pingpong(0, 0, 0, &st) == 0)
+        bench_stats_log(log_fp, "Pipe round trip (same core)", "ns", &st);
+    if (measure_pingpong(1, 0, 0, &st) == 0)
+        bench_stats_log(log_fp, "Futex round trip (same core)", "ns", &st);
+    if (cpus > 1) {
+        if (measure_pingpong(0, 0, 1, &st) == 0)
+            bench_stats_log(log_fp, "Pipe round trip (cross core)", "ns", &st);
+        if (measure_pingpong(1, 0, 1, &st) == 0)
+            bench_stats_log(log_fp, "Futex round trip (cross core)", "ns", &st);
+    } else {
+        fprintf(log_fp, "Cross-core round trips skipped (1 CPU online)\n");
+        printf("Cross-core round trips skipped (1 CPU online)\n");
+    }
+
+    bench_measure(thread_create_join, NULL, 200, OS_SAMPLES, &st);
+    bench_stats_log(log_fp, "pthread_create + join", "ns", &st);
+
+    bench_measure(fork_wait, NULL, 10, OS_SAMPLES / 3, &st);
+    bench_stats_log(log_fp, "fork + waitpid", "ns", &st);
+
+    bench_measure(spawn_wait, NULL, 10, OS_SAMPLES / 3, &st);
+    bench_stats_log(log_fp, "posix_spawn(/bin/true) + waitpid", "ns", &st);
+
+    measure_minor_faults(&st);
+    bench_stats_log(log_fp, "Minor page fault (per page)", "ns", &st);
+
+    if (measure_major_faults(&st) == 0) {
+        bench_stats_log(log_fp, "Major page fault (per fault)", "ns", &st);
+    } else {
+        fprintf(log_fp, "Major page fault: not measurable (no major faults provoked)\n");
+        printf("Major page fault: not measurable (no major faults provoked)\n");
+    }
+}
@@ -0,0 +1,13 @@
+#ifndef OS_BENCH_H
+#define OS_BENCH_H
+
+#include <stdio.h>
+
+/**
+ * @brief Kernel-cost microbenchmarks (syscalls, context switches, thread and
+ *        process creation, page faults).
+ * @param log_fp Pointer to the hardware_info.txt file.
+ */
+void run_os_overhead_benchmark(FILE *log_fp);
+
+#endif
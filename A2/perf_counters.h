@@ -0,0 +1,30 @@
+#ifndef PERF_COUNTERS_H
+#define PERF_COUNTERS_H
+
+#include <stdint.h>
+
+/**
+ * @brief One hardware event counted for the calling thread via perf_event_open().
+ * @details fd is -1 when the event is unsupported or perf access is denied
+ *          (see /proc/sys/kernel/perf_event_paranoid); reads then return 0.
+ */
+typedef struct {
+    int fd;
+} perf_counter_t;
+
+/**
+ * @brief Opens a disabled user+kernel counter. Returns 0 on success, -1 otherwise.
+ */
+int perf_counter_open(perf_counter_t *pc, uint32_t type, uint64_t config);
+
+/**
+ * @brief Opens a counter for cache lines read from DRAM: L2D_CACHE_REFILL
+ *        (raw 0x17) on Arm, LLC misses elsewhere.
+ */
+int perf_counter_open_dram_reads(perf_counter_t *pc);
+
+void perf_counter_start(perf_counter_t *pc);
+uint64_t perf_counter_stop(perf_counter_t *pc);
+void perf_counter_close(perf_counter_t *pc);
+
+#endif